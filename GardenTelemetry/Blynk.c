@@ -49,6 +49,12 @@
 #include "PWM.h"
 #include "SysTick.h"
 #include "ADCSWTrigger.h"
+#include "timeseries.h"
+#include "stats.h"
+#include "ui.h"
+#include "dashboard.h"
+#include "events.h"
+#include "bench.h"
 
 #define PF0       		(*((volatile uint32_t *)0x40025004))
 #define PF1       		(*((volatile uint32_t *)0x40025008))
@@ -59,6 +65,7 @@
 #define EMAIL_PIN 98
 #define COMMAND_TX_PIN 99
 #define COMMAND_RX_PIN 14
+#define STRIP_CHART_PIN 15      // any write switches to the scrolling trace of the VP13 sensor
 
 #define HEATER_PIN 2
 #define WATER_PIN 3
@@ -71,15 +78,37 @@
 #define TURN_OFF_LIGHT 4
 #define TURN_ON_LIGHT 5
 
+// bulk settings, "pin,v1,v2,...,vn" with exactly n values, applied together or not at all
+#define THRESHOLDS_PIN 20       // low limits for sensors 1 to 3
+#define SCHEDULE_PIN 21         // grow light duty in percent for hours 0 to 23, -1 leaves the hour to VP1
+#define TIME_PIN 22             // hour 0 to 23, minute, second
+#define CONFIG_MAX_VALUES 24
+
+#define SEND_PERIOD 40000000                          // Timer3 reload, 0.5 s at 80 MHz
+#define SAMPLES_PER_MINUTE (60 * (80000000 / SEND_PERIOD))
+
+// window statistics go out once per window on six pins per sensor
+// sensor n uses VP(STATS_PIN_BASE + 6n) to VP(STATS_PIN_BASE + 6n + 5)
+#define STATS_WINDOW SAMPLES_PER_MINUTE
+#define STATS_PIN_BASE 80
+
+// writing 0, 1 or 2 to HISTORY_PIN uploads the raw, minute or hour history of every
+// sensor, sensor n on VP(HISTORY_PIN_BASE + n), a few frames per SendInformation
+#define HISTORY_PIN 23
+#define HISTORY_PIN_BASE 70
+#define HISTORY_FRAMES_PER_SEND 2
+
 void WaitForInterrupt(void);    // Defined in startup.s
+long StartCritical (void);      // previous I bit, disable interrupts
+void EndCritical(long sr);      // restore I bit to previous value
 
 void masterMain(void);
 
 uint32_t LED;      // VP1
 // These 6 variables contain the most recent Blynk to TM4C123 message
 // Blynk to TM4C123 uses VP0 to VP15
-char serial_buf[64];
-char Pin_Number[2]   = "99";       // Initialize to invalid pin number
+char serial_buf[ESP8266_MESSAGESIZE];
+char Pin_Number[4]   = "99";       // Initialize to invalid pin number
 char Pin_Integer[8]  = "0000";     //
 char Pin_Float[8]    = "0.0000";   //
 uint32_t pin_num; 
@@ -91,10 +120,24 @@ int readingLimit3 = 400;
 
 int editTime = 0;
 
-int growLightDuty = 0;
+int growLightDuty = 0;           // VP1, the duty set by hand for hours the schedule leaves at -1
+int growLightOutput = 0;         // duty on PWM0B now, only SendInformation changes it
+int8_t lightSchedule[24] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
 
 int isMaster;
 
+int profileRequested = 0;        // VP11 asks for an LCD traffic report on UART0
+int rxStatsRequested = 0;        // VP12 asks for the UART5 receive and transmit counters on UART0
+
+int volatile historyRequest = -1; // level written to HISTORY_PIN, -1 when none is waiting
+int historyLevel = -1;           // TS_RAW, TS_MINUTE or TS_HOUR being uploaded, -1 when idle
+uint32_t historySensor;          // next sensor to read
+uint32_t historyNext;            // next point of the sensor being sent
+uint32_t historyCount;           // points read for the sensor being sent
+TimeSeries_Bucket historyPoints[TS_RAW_SIZE];
+int32_t historyValues[TS_RAW_SIZE];
+
 void initActuators()
 {
   SYSCTL_RCGCGPIO_R |= 0x02;            // 2) activate port B
@@ -133,23 +176,132 @@ void changeLightState(int state)
 // Send data to the Blynk App
 // It uses Virtual Pin numbers between 70 and 99
 // so that the ESP8266 knows to forward the data to the Blynk App
+// Alerts and commands to the other board go ahead of any queued readings
 void TM4C_to_Blynk(uint32_t pin,uint32_t value){
+  uint32_t tier = ESP8266_TELEMETRY;
   if((pin < 70)||(pin > 99)){
     return; // ignore illegal requests
   }
+  if((pin == EMAIL_PIN)||(pin == COMMAND_TX_PIN)){
+    tier = ESP8266_ALERT;
+  }
 // your account will be temporarily halted if you send too much data
-  ESP8266_OutUDec(pin);       // Send the Virtual Pin #
-  ESP8266_OutChar(',');
-  ESP8266_OutUDec(value);      // Send the current value
-  ESP8266_OutChar(',');
-  ESP8266_OutString("0.0\n");  // Null value not used in this example
+  ESP8266_SendPin(tier, pin, value); // CSV or a binary frame, whichever the bridge accepted
 }
  
  
+// copies the next CSV field of the message strtok is working on, cut to size-1
+// characters, returns 0 if the message has no more fields
+int static nextField(char *field, uint32_t size, char *message){
+  char *token = strtok(message, ",\n");
+  if(token == NULL){
+    return 0;
+  }
+  strncpy(field, token, size - 1);
+  field[size - 1] = 0;
+  return 1;
+}
+
+// reads the rest of the message strtok is working on as whole numbers
+// returns how many there were, or -1 if one is not a number or there are more than max
+int static readValues(int32_t *values, int max){
+  char *token; char *end; int count = 0;
+  while((token = strtok(NULL, ",\n")) != NULL){
+    if(count == max){
+      return -1;
+    }
+    values[count] = strtol(token, &end, 10);
+    if((end == token) || (*end != 0)){
+      return -1;
+    }
+    count++;
+  }
+  return count;
+}
+
+int static inRange(const int32_t *values, int count, int32_t low, int32_t high){
+  for(int i = 0; i < count; i++){
+    if((values[i] < low) || (values[i] > high)){
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// checks every value before changing anything, so a bad message leaves the old settings
+void static applySettings(uint32_t pin){
+  int32_t values[CONFIG_MAX_VALUES];
+  int count = readValues(values, CONFIG_MAX_VALUES);
+  long sr;
+  if(pin == THRESHOLDS_PIN){
+    if((count != 3) || !inRange(values, 3, 0, 4095)) {return;}
+    sr = StartCritical();    // SendInformation compares against all three
+    readingLimit1 = values[0];
+    readingLimit2 = values[1];
+    readingLimit3 = values[2];
+    EndCritical(sr);
+  }
+  else if(pin == SCHEDULE_PIN){
+    if((count != 24) || !inRange(values, 24, -1, 100)) {return;}
+    sr = StartCritical();
+    for(int i = 0; i < 24; i++) {lightSchedule[i] = values[i];}
+    EndCritical(sr);
+  }
+  else if(pin == TIME_PIN){
+    if((count != 3) || !inRange(values, 1, 0, 23) || !inRange(&values[1], 2, 0, 59)) {return;}
+    setTimeOfDay(values[0], values[1], values[2]);
+  }
+}
+
+// restarts the upload, taken up by the next SendInformation
+// runs in Timer2, which preempts sendHistory, so only the level is stored here
+void static requestHistory(uint32_t level)
+{
+	if(level > TS_HOUR) {return;}
+	historyRequest = level;
+}
+
+// Sends up to HISTORY_FRAMES_PER_SEND batches of the requested history,
+// mean of each bucket, oldest first. A batch holds about 50 slowly
+// changing readings, where CSV needs a line of about 12 bytes for each
+// and a batch is the lines the bulk tier has room for
+void static sendHistory(void)
+{
+	static const uint32_t intervalMs[3] = {SEND_PERIOD / 80000, 60000, 3600000};
+	long sr = StartCritical();    // take the request and clear it as one step
+	int request = historyRequest;
+	historyRequest = -1;
+	EndCritical(sr);
+	if(request >= 0)
+	{
+		historyLevel = request;
+		historySensor = 0;
+		historyNext = 0;
+		historyCount = 0;
+	}
+	for(int frames = 0; (historyLevel >= 0) && (frames < HISTORY_FRAMES_PER_SEND); frames++)
+	{
+		while(historyNext == historyCount)		//skips sensors with no history yet
+		{
+			if(historySensor == TS_NUM_SENSORS) {historyLevel = -1; return;}
+			historyCount = TimeSeries_Read(historySensor, historyLevel, TS_RAW_SIZE, historyPoints);
+			for(uint32_t i = 0; i < historyCount; i++) {historyValues[i] = historyPoints[i].mean;}
+			historyNext = 0;
+			historySensor++;
+		}
+		uint32_t sent = ESP8266_SendBatch(ESP8266_BULK, HISTORY_PIN_BASE + historySensor - 1, intervalMs[historyLevel],
+		                                  &historyValues[historyNext], historyCount - historyNext);
+		if(sent == 0) {return;}		//bulk tier is full, the same samples go next time
+		historyNext += sent;
+	}
+}
+
 // -------------------------   Blynk_to_TM4C  -----------------------------------
 // This routine receives the Blynk Virtual Pin data via the ESP8266 and parses the
 // data and feeds the commands to the TM4C.
+// Runs EVENT_TICK_HZ times a second on Timer2, which also paces the screen
 void Blynk_to_TM4C(void){int j; char data;
+  Event_Tick();
 // Check to see if a there is data in the RXD buffer
   if(ESP8266_GetMessage(serial_buf)){  // returns false if no message
     // Read the data from the UART5
@@ -166,17 +318,26 @@ void Blynk_to_TM4C(void){int j; char data;
            
 // Rip the 3 fields out of the CSV data. The sequence of data from the 8266 is:
 // Pin #, Integer Value, Float Value.
-    strcpy(Pin_Number, strtok(serial_buf, ","));
-    strcpy(Pin_Integer, strtok(NULL, ","));       // Integer value that is determined by the Blynk App
-    strcpy(Pin_Float, strtok(NULL, ","));         // Not used
+    if(!nextField(Pin_Number, sizeof(Pin_Number), serial_buf) ||
+       Pin_Number[0] < '0' || Pin_Number[0] > '9'){
+      return;                   // malformed, atoi would turn it into VP0
+    }
     pin_num = atoi(Pin_Number);     // Need to convert ASCII to integer
+    if((pin_num >= THRESHOLDS_PIN) && (pin_num <= TIME_PIN)){
+      applySettings(pin_num);
+      Event_Post(EVENT_MESSAGE);
+      return;
+    }
+    if(!nextField(Pin_Integer, sizeof(Pin_Integer), NULL)){        // Integer value that is determined by the Blynk App
+      return;
+    }
+    nextField(Pin_Float, sizeof(Pin_Float), NULL);                 // Not used, and not sent in binary frames
     pin_int = atoi(Pin_Integer);  
   // ---------------------------- VP #1 ----------------------------------------
   // This VP is the LED select button
 		if(pin_num == 1)
 		{
-			growLightDuty = pin_int;
-			PWM0B_Duty(400 * growLightDuty);
+			growLightDuty = pin_int;     // SendInformation puts it on PWM0B
 		}   
 		else if(pin_num == 0x02)
 		{
@@ -199,6 +360,28 @@ void Blynk_to_TM4C(void){int j; char data;
 				setMode(GRAPH_SENSORS_MODE);
 			}
 		}
+		else if(pin_num == 0x0A)
+		{
+			if(getMode() != DASHBOARD_MODE)
+			{
+				setMode(DASHBOARD_MODE);
+			}
+		}
+		else if(pin_num == STRIP_CHART_PIN)
+		{
+			if(getMode() != STRIP_CHART_MODE)
+			{
+				setMode(STRIP_CHART_MODE);
+			}
+		}
+		else if(pin_num == 0x0B)
+		{
+			profileRequested = 1;
+		}
+		else if(pin_num == 0x0C)
+		{
+			rxStatsRequested = 1;
+		}
 		else if(pin_num == 0x05)
 		{
 			if(editTime == 1)
@@ -241,6 +424,10 @@ void Blynk_to_TM4C(void){int j; char data;
 		{
 			setSensor(pin_int);
 		}
+		else if(pin_num == HISTORY_PIN)
+		{
+			requestHistory(pin_int);
+		}
 		else if(pin_num == COMMAND_RX_PIN)
 		{
 			switch(pin_int)
@@ -270,9 +457,25 @@ void Blynk_to_TM4C(void){int j; char data;
 				break;
 			}
 		}
+		Event_Post(EVENT_MESSAGE);
   }  
 }
 
+// Sends the summary of a sensor's last statistics window:
+// mean, standard deviation, min, max, median, 95th percentile
+void SendStatistics(uint32_t sensor)
+{
+	Stats_Summary summary;
+	uint32_t pin = STATS_PIN_BASE + 6 * sensor;
+	Stats_GetSummary(sensor, &summary);
+	TM4C_to_Blynk(pin, summary.mean);
+	TM4C_to_Blynk(pin + 1, summary.stdDev);
+	TM4C_to_Blynk(pin + 2, summary.min);
+	TM4C_to_Blynk(pin + 3, summary.max);
+	TM4C_to_Blynk(pin + 4, summary.median);
+	TM4C_to_Blynk(pin + 5, summary.p95);
+}
+
 void SendInformation(void)
 {
 	// your account will be temporarily halted if you send too much data
@@ -281,62 +484,138 @@ void SendInformation(void)
 	int reading3 = 1200;
 	//int reading2 = ADC0_InSeq1();
 	//int reading3 = ADC0_InSeq2();
+	long sr = StartCritical();    // Timer2 may replace the limits while we compare
+	int limit1 = readingLimit1;
+	int limit2 = readingLimit2;
+	int limit3 = readingLimit3;
+	EndCritical(sr);
+	
+	TimeSeries_Put(0, reading1);
+	TimeSeries_Put(1, reading2);
+	TimeSeries_Put(2, reading3);
+	if(Stats_Put(0, reading1)) {SendStatistics(0);}
+	if(Stats_Put(1, reading2)) {SendStatistics(1);}
+	if(Stats_Put(2, reading3)) {SendStatistics(2);}
+	Dashboard_Tick(SEND_PERIOD / 80000);
+	Event_Post(EVENT_SAMPLE);
 	
   PortF_Output(1, 1);	
 	
 	TM4C_to_Blynk(74, reading1);  // VP74
+	int duty = lightSchedule[getHourOfDay()];
+	if(duty < 0) {duty = growLightDuty;}
+	if(duty != growLightOutput)
+	{
+		growLightOutput = duty;
+		PWM0B_Duty(400 * growLightOutput);
+	}
 	if(getMode() == GRAPH_SENSORS_MODE)
 	{
-		putData(reading1);
+		int readings[3] = {reading1, reading2, reading3};
+		putData(readings[(uint32_t)getSensor() % 3]);		//sensor picked on VP13
+	}
+	else if(getMode() == STRIP_CHART_MODE)
+	{
+		int readings[3] = {reading1, reading2, reading3};
+		putStripSample(readings[(uint32_t)getSensor() % 3]);
 	}
 	
-	if(reading1 <= readingLimit1 && isMaster)
+	if(reading1 <= limit1 && isMaster)
 	{
 		TM4C_to_Blynk(EMAIL_PIN, reading1);
 		TM4C_to_Blynk(COMMAND_TX_PIN, TURN_ON_HEATER);
 		changeHeaterState(1);
 	}
-	else if(reading1 > readingLimit1 && isMaster)
+	else if(reading1 > limit1 && isMaster)
 	{
 		TM4C_to_Blynk(COMMAND_TX_PIN, TURN_OFF_HEATER);
 		changeHeaterState(0);
 	}
 	
-	if(reading2 <= readingLimit2 && isMaster)
+	if(reading2 <= limit2 && isMaster)
 	{
 		TM4C_to_Blynk(EMAIL_PIN, reading2);
 		TM4C_to_Blynk(COMMAND_TX_PIN, TURN_ON_WATER);
 		changeWaterState(1);
 	}
-	else if(reading2 > readingLimit2 && isMaster)
+	else if(reading2 > limit2 && isMaster)
 	{
 		TM4C_to_Blynk(COMMAND_TX_PIN, TURN_OFF_WATER);
 		changeWaterState(0);
 	}
 	
-	if(reading3 <= readingLimit3 && isMaster)
+	if(reading3 <= limit3 && isMaster)
 	{
 		TM4C_to_Blynk(EMAIL_PIN, reading3);
 		TM4C_to_Blynk(COMMAND_TX_PIN, TURN_ON_LIGHT);
 		changeLightState(1);
 	}
-	else if(reading3 > readingLimit3 && isMaster)
+	else if(reading3 > limit3 && isMaster)
 	{
 		TM4C_to_Blynk(COMMAND_TX_PIN, TURN_OFF_LIGHT);
 		changeLightState(0);
 	}
+	sendHistory();
 	
 	PortF_Output(1, 0);
 }
 
+// one CSV line, header first, so a log can be graphed over time
+void static printRxStats(void)
+{
+#ifdef DEBUG1
+	ESP8266_RxStats stats;
+	ESP8266_GetRxStats(&stats);
+	UART_OutString("rx,overruns,line_errors,dropped,truncated,high_water,high_water_bytes,bad_frames,waiting\r\nrx,");
+	UART_OutUDec(stats.overruns); UART_OutChar(',');
+	UART_OutUDec(stats.lineErrors); UART_OutChar(',');
+	UART_OutUDec(stats.dropped); UART_OutChar(',');
+	UART_OutUDec(stats.truncated); UART_OutChar(',');
+	UART_OutUDec(stats.highWater); UART_OutChar(',');
+	UART_OutUDec(stats.highWaterBytes); UART_OutChar(',');
+	UART_OutUDec(stats.badFrames); UART_OutChar(',');
+	UART_OutUDec(stats.waiting);
+	UART_OutString("\r\n");
+#endif
+}
+
+// one CSV line per uplink tier, alert first
+void static printTxStats(void)
+{
+#ifdef DEBUG1
+	ESP8266_TxStats stats;
+	UART_OutString("tx,tier,messages,bytes,waiting,high_water,max_wait_ms,mean_wait_ms,dropped,rejected\r\n");
+	for(uint32_t tier = 0; tier < ESP8266_TIERS; tier++)
+	{
+		ESP8266_GetTxStats(tier, &stats);
+		UART_OutString("tx,"); UART_OutUDec(tier); UART_OutChar(',');
+		UART_OutUDec(stats.messages); UART_OutChar(',');
+		UART_OutUDec(stats.bytes); UART_OutChar(',');
+		UART_OutUDec(stats.waiting); UART_OutChar(',');
+		UART_OutUDec(stats.highWater); UART_OutChar(',');
+		UART_OutUDec(stats.maxWaitMs); UART_OutChar(',');
+		UART_OutUDec(stats.meanWaitMs); UART_OutChar(',');
+		UART_OutUDec(stats.dropped); UART_OutChar(',');
+		UART_OutUDec(stats.rejected);
+		UART_OutString("\r\n");
+	}
+#endif
+}
+
   
 int main(void)
 {       
   PLL_Init(Bus80MHz);   // Bus clock at 80 MHz
+#ifdef ST7735_TRACE
+  UART_Init(5);         // the SSI0 trace starts with the first LCD command
+#endif
 	ST7735_InitR(INITR_REDTAB);
   DisableInterrupts();  // Disable interrupts until finished with inits
 	initActuators();
   initSensors();
+	TimeSeries_Init(SAMPLES_PER_MINUTE);
+	initSensorGraph();
+	Stats_Init(STATS_WINDOW);
 	Output_Init(); 
 	PortF_Init();
 	
@@ -351,22 +630,30 @@ void masterMain()
 {
 	
 #ifdef DEBUG1
+#ifndef ST7735_TRACE
   UART_Init(5);         // Enable Debug Serial Port
+#endif
   UART_OutString("\n\rEE445L Lab 4D\n\rBlynk example");
 #endif
   
 	ESP8266_Init();       // Enable ESP8266 Serial Port
+#if defined(DEBUG1) && defined(BENCHMARK)
+  Bench_Run();          // hot path timings as CSV, needs UART5 up, before the timers start
+#endif
   ESP8266_Reset();      // Reset the WiFi module
   ESP8266_SetupWiFi();  // Setup communications to Blynk Server  
+	Ui_Clear();           // setup messages were drawn outside the ui layer
   
-  Timer2_Init(&Blynk_to_TM4C, 800000); 
-  Timer3_Init(&SendInformation, 40000000); 
-	PWM0B_Init(40000, 400 * growLightDuty);
+  Timer2_Init(&Blynk_to_TM4C, 80000000 / EVENT_TICK_HZ); 
+  Timer3_Init(&SendInformation, SEND_PERIOD); 
+	PWM0B_Init(40000, 400 * growLightOutput);
 	
-	SysTick_Init();
+	SysTick_Init();       // its interrupt toggles PF0 as a heartbeat, the count measures time asleep
+	Event_Post(EVENT_MODE);
 	EnableInterrupts();
   while(1) 
 	{   
+		Event_WaitFrame();    // sleeps until something changed and a frame is due
 		switch(getMode())
 		{
 			case CLOCK_MODE:
@@ -380,6 +667,27 @@ void masterMain()
 			case GRAPH_SENSORS_MODE:
 			graphSensorsMode();
 			break;
+			
+			case DASHBOARD_MODE:
+			dashboardMode();
+			break;
+			
+			case STRIP_CHART_MODE:
+			stripChartMode();
+			break;
+		}
+		ST7735_TraceFrame();
+		ESP8266_CaptureFlush();
+		if(profileRequested)
+		{
+			profileRequested = 0;
+			ST7735_ProfileReport();		//printed here, not in the Timer2 ISR, since it fills the UART0 FIFO
+		}
+		if(rxStatsRequested)
+		{
+			rxStatsRequested = 0;
+			printRxStats();
+			printTxStats();
 		}
 		
   }
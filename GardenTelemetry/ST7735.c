@@ -137,8 +137,10 @@ uint16_t StTextColor = ST7735_YELLOW;
 #define ST7735_RAMRD   0x2E
 
 #define ST7735_PTLAR   0x30
+#define ST7735_VSCRDEF 0x33
 #define ST7735_COLMOD  0x3A
 #define ST7735_MADCTL  0x36
+#define ST7735_VSCSAD  0x37
 
 #define ST7735_FRMCTR1 0xB1
 #define ST7735_FRMCTR2 0xB2
@@ -526,26 +528,152 @@ static int16_t _height = ST7735_TFTHEIGHT;
 // and then adds the data to the transmit FIFO.
 // NOTE: These functions will crash or stall indefinitely if
 // the SSI0 module is not initialized and enabled.
+#ifdef ST7735_TRACE
+#include "UART.h"
+// trace is polled out behind any queued UART_OutChar text, so it does not
+// interleave with DEBUG1 output and drawing with interrupts disabled cannot
+// deadlock on a full software FIFO
+void static traceChar(char c){
+  UART_OutCharPolled(c);
+}
+void static traceByte(char tag, uint8_t c){
+  static const char hex[] = "0123456789ABCDEF";
+  traceChar(tag);
+  traceChar(hex[c >> 4]);
+  traceChar(hex[c & 0x0F]);
+}
+void ST7735_TraceFrame(void){
+  traceChar('\n');
+  traceChar('F');
+}
+#define TRACE_COMMAND(c) {traceChar('\n'); traceByte('C', c);}
+#define TRACE_DATA(c)    traceByte(' ', c)
+#else
+#define TRACE_COMMAND(c)
+#define TRACE_DATA(c)
+#endif
+
+#ifdef ST7735_PROFILE
+#include "UART.h"
+enum profilePrimitive{
+  ST7735_PROF_OTHER,              // init, rotation, or outside any primitive
+  ST7735_PROF_PIXEL,
+  ST7735_PROF_VLINE,
+  ST7735_PROF_HLINE,
+  ST7735_PROF_FILLRECT,
+  ST7735_PROF_CIRCLE,
+  ST7735_PROF_BITMAP,
+  ST7735_PROF_RLEBITMAP,
+  ST7735_PROF_CHAR,
+  ST7735_PROF_STRING,
+  ST7735_PROF_COLUMNBITS,
+  ST7735_PROF_STRIPCHART,
+  ST7735_PROF_COUNT
+};
+static char *const ProfileName[ST7735_PROF_COUNT] = {
+  "other", "DrawPixel", "DrawFastVLine", "DrawFastHLine", "FillRect", "DrawCircle",
+  "DrawBitmap", "DrawRLEBitmap", "DrawChar", "DrawString", "DrawColumnBits", "StripChart"
+};
+typedef struct{
+  uint32_t calls;
+  uint32_t bytes;
+  uint32_t windows;                // setAddrWindow calls
+  uint32_t wait;                   // bus cycles spent spinning on SSI0
+} profileCount;
+static profileCount ProfilePrimitive[ST7735_PROF_COUNT];
+static profileCount ProfileTag[ST7735_PROFILE_TAGS];
+static uint8_t ProfileCurrent = ST7735_PROF_OTHER;   // outermost primitive running
+static uint8_t ProfileTagNow = 0;
+static uint32_t ProfileTotalBytes = 0;   // never cleared
+
+// only the outermost primitive is charged, a nested one leaves it in place
+uint8_t static profileEnter(uint8_t id){
+  uint8_t outer = ProfileCurrent;
+  if(outer == ST7735_PROF_OTHER){
+    ProfileCurrent = id;
+    ProfilePrimitive[id].calls++;
+    ProfileTag[ProfileTagNow].calls++;
+  }
+  return outer;
+}
+// SysTick counts down from its reload value, a wait is far shorter than a period
+void static profileWait(uint32_t start){
+  uint32_t end = NVIC_ST_CURRENT_R;
+  uint32_t cycles;
+  if((NVIC_ST_CTRL_R&0x01) == 0) return;    // SysTick not running
+  if(end <= start){
+    cycles = start - end;
+  } else{
+    cycles = start + (NVIC_ST_RELOAD_R&0x00FFFFFF) + 1 - end;
+  }
+  ProfilePrimitive[ProfileCurrent].wait += cycles;
+  ProfileTag[ProfileTagNow].wait += cycles;
+}
+uint32_t ST7735_ProfileBytes(void){
+  return ProfileTotalBytes;
+}
+void ST7735_ProfileTag(uint32_t tag){
+  ProfileTagNow = (tag < ST7735_PROFILE_TAGS) ? tag : (ST7735_PROFILE_TAGS - 1);
+}
+void static profileLine(char *name, uint32_t index, const profileCount *count){
+  if((count->calls == 0) && (count->bytes == 0)) return;
+  UART_OutString(name);
+  if(index < ST7735_PROFILE_TAGS){ UART_OutUDec(index); }
+  UART_OutChar(','); UART_OutUDec(count->calls);
+  UART_OutChar(','); UART_OutUDec(count->bytes);
+  UART_OutChar(','); UART_OutUDec(count->windows);
+  UART_OutChar(','); UART_OutUDec(count->wait);
+  UART_OutString("\r\n");
+}
+void ST7735_ProfileReport(void){
+  uint32_t i;
+  UART_OutString("\r\nname,calls,bytes,windows,wait\r\n");
+  for(i = 0; i < ST7735_PROF_COUNT; i++){
+    profileLine(ProfileName[i], ST7735_PROFILE_TAGS, &ProfilePrimitive[i]);
+    ProfilePrimitive[i] = (profileCount){0};
+  }
+  for(i = 0; i < ST7735_PROFILE_TAGS; i++){
+    profileLine("tag", i, &ProfileTag[i]);
+    ProfileTag[i] = (profileCount){0};
+  }
+}
+#define PROFILE_ENTER(id)  uint8_t profileOuter = profileEnter(id)
+#define PROFILE_EXIT()     ProfileCurrent = profileOuter
+#define PROFILE_BYTE()     {ProfilePrimitive[ProfileCurrent].bytes++; ProfileTag[ProfileTagNow].bytes++; ProfileTotalBytes++;}
+#define PROFILE_WINDOW()   {ProfilePrimitive[ProfileCurrent].windows++; ProfileTag[ProfileTagNow].windows++;}
+#define SPIN_WHILE(cond)   {uint32_t spinStart = NVIC_ST_CURRENT_R; while(cond){}; profileWait(spinStart);}
+#else
+#define PROFILE_ENTER(id)
+#define PROFILE_EXIT()
+#define PROFILE_BYTE()
+#define PROFILE_WINDOW()
+#define SPIN_WHILE(cond)   while(cond){}
+#endif
+
 void static writecommand(uint8_t c) {
+  TRACE_COMMAND(c);
+  PROFILE_BYTE();
                                         // wait until SSI0 not busy/transmit FIFO empty
-  while((SSI0_SR_R&SSI_SR_BSY)==SSI_SR_BSY){};
+  SPIN_WHILE((SSI0_SR_R&SSI_SR_BSY)==SSI_SR_BSY);
   TFT_CS = TFT_CS_LOW;
   DC = DC_COMMAND;
   SSI0_DR_R = c;                        // data out
                                         // wait until SSI0 not busy/transmit FIFO empty
-  while((SSI0_SR_R&SSI_SR_BSY)==SSI_SR_BSY){};
+  SPIN_WHILE((SSI0_SR_R&SSI_SR_BSY)==SSI_SR_BSY);
 }
 
 
 void static writedata(uint8_t c) {
-  while((SSI0_SR_R&SSI_SR_TNF)==0){};   // wait until transmit FIFO not full
+  TRACE_DATA(c);
+  PROFILE_BYTE();
+  SPIN_WHILE((SSI0_SR_R&SSI_SR_TNF)==0);   // wait until transmit FIFO not full
   DC = DC_DATA;
   SSI0_DR_R = c;                        // data out
 }
 
 void static deselect(void) {
                                         // wait until SSI0 not busy/transmit FIFO empty
-  while((SSI0_SR_R&SSI_SR_BSY)==SSI_SR_BSY){};
+  SPIN_WHILE((SSI0_SR_R&SSI_SR_BSY)==SSI_SR_BSY);
   TFT_CS = TFT_CS_HIGH;    
 }
 
@@ -827,6 +955,7 @@ void ST7735_InitR(enum initRFlags option) {
 // (same as Font table is encoded; different from regular bitmap)
 // Requires 11 bytes of transmission
 void static setAddrWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+  PROFILE_WINDOW();
 
   writecommand(ST7735_CASET); // Column addr set
   writedata(0x00);
@@ -864,8 +993,9 @@ void static pushColor(uint16_t color) {
 //        color 16-bit color, which can be produced by ST7735_Color565()
 // Output: none
 void ST7735_DrawPixel(int16_t x, int16_t y, uint16_t color) {
+  PROFILE_ENTER(ST7735_PROF_PIXEL);
 
-  if((x < 0) || (x >= _width) || (y < 0) || (y >= _height)) return;
+  if((x < 0) || (x >= _width) || (y < 0) || (y >= _height)) {PROFILE_EXIT(); return;}
 
 //  setAddrWindow(x,y,x+1,y+1); // original code, bug???
   setAddrWindow(x,y,x,y);
@@ -873,6 +1003,7 @@ void ST7735_DrawPixel(int16_t x, int16_t y, uint16_t color) {
   pushColor(color);
 
   deselect();
+  PROFILE_EXIT();
 }
 
 
@@ -886,10 +1017,11 @@ void ST7735_DrawPixel(int16_t x, int16_t y, uint16_t color) {
 //        color 16-bit color, which can be produced by ST7735_Color565()
 // Output: none
 void ST7735_DrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  PROFILE_ENTER(ST7735_PROF_VLINE);
   uint8_t hi = color >> 8, lo = color;
 
   // Rudimentary clipping
-  if((x >= _width) || (y >= _height)) return;
+  if((x >= _width) || (y >= _height)) {PROFILE_EXIT(); return;}
   if((y+h-1) >= _height) h = _height-y;
   setAddrWindow(x, y, x, y+h-1);
 
@@ -899,6 +1031,73 @@ void ST7735_DrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
   }
 
   deselect();
+  PROFILE_EXIT();
+}
+
+
+//------------ST7735_DrawColumnBits------------
+// Draw a run of pixels down one column in a single address window, each
+// pixel colored by one bit of a bit array (1 = fgColor, 0 = bgColor).
+// Requires (11 + 2*h) bytes of transmission (assuming image fully on screen)
+// Input: x        horizontal position of the column, columns from the left edge
+//        y        vertical position of the first pixel, rows from the top edge
+//        h        number of pixels to draw
+//        bits     bit array, bit n is word n/32, bit n%32
+//        firstBit index of the bit used for the pixel at row y
+//        fgColor  16-bit color for set bits
+//        bgColor  16-bit color for clear bits
+// Output: none
+void ST7735_DrawColumnBits(int16_t x, int16_t y, int16_t h, const uint32_t *bits, int16_t firstBit, uint16_t fgColor, uint16_t bgColor) {
+  PROFILE_ENTER(ST7735_PROF_COLUMNBITS);
+  uint32_t bit = firstBit;
+
+  // Rudimentary clipping
+  if((x >= _width) || (y >= _height) || (h <= 0)) {PROFILE_EXIT(); return;}
+  if((y+h-1) >= _height) h = _height-y;
+  setAddrWindow(x, y, x, y+h-1);
+
+  while (h--) {
+    pushColor((bits[bit >> 5] & (1UL << (bit & 31))) ? fgColor : bgColor);
+    bit++;
+  }
+
+  deselect();
+  PROFILE_EXIT();
+}
+
+
+//------------ST7735_DrawBitColumns------------
+// Draw a block of pixels in a single address window, each column given
+// by one word of bits (bit n is the pixel n rows below y, 1 = fgColor,
+// 0 = bgColor), so a strip of short columns costs one window.
+// Requires (11 + 2*w*h) bytes of transmission (assuming image fully on screen)
+// Input: x        horizontal position of the left column, columns from the left edge
+//        y        vertical position of the top row, rows from the top edge
+//        w        number of columns, words in columns
+//        h        number of rows, 1 to 32
+//        columns  one word per column, left column first
+//        fgColor  16-bit color for set bits
+//        bgColor  16-bit color for clear bits
+// Output: none
+void ST7735_DrawBitColumns(int16_t x, int16_t y, int16_t w, int16_t h, const uint32_t *columns, uint16_t fgColor, uint16_t bgColor) {
+  PROFILE_ENTER(ST7735_PROF_COLUMNBITS);
+  int16_t row, col;
+
+  // Rudimentary clipping
+  if((x >= _width) || (y >= _height) || (w <= 0) || (h <= 0)) {PROFILE_EXIT(); return;}
+  if(h > 32) h = 32;
+  if((x+w-1) >= _width)  w = _width-x;
+  if((y+h-1) >= _height) h = _height-y;
+  setAddrWindow(x, y, x+w-1, y+h-1);
+
+  for(row = 0; row < h; row++) {          // the window fills a row at a time
+    for(col = 0; col < w; col++) {
+      pushColor((columns[col] & (1UL << row)) ? fgColor : bgColor);
+    }
+  }
+
+  deselect();
+  PROFILE_EXIT();
 }
 
 
@@ -912,10 +1111,11 @@ void ST7735_DrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
 //        color 16-bit color, which can be produced by ST7735_Color565()
 // Output: none
 void ST7735_DrawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  PROFILE_ENTER(ST7735_PROF_HLINE);
   uint8_t hi = color >> 8, lo = color;
 
   // Rudimentary clipping
-  if((x >= _width) || (y >= _height)) return;
+  if((x >= _width) || (y >= _height)) {PROFILE_EXIT(); return;}
   if((x+w-1) >= _width)  w = _width-x;
   setAddrWindow(x, y, x+w-1, y);
 
@@ -925,6 +1125,7 @@ void ST7735_DrawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
   }
 
   deselect();
+  PROFILE_EXIT();
 }
 
 
@@ -949,10 +1150,11 @@ void ST7735_FillScreen(uint16_t color) {
 //        color 16-bit color, which can be produced by ST7735_Color565()
 // Output: none
 void ST7735_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  PROFILE_ENTER(ST7735_PROF_FILLRECT);
   uint8_t hi = color >> 8, lo = color;
 
   // rudimentary clipping (drawChar w/big text requires this)
-  if((x >= _width) || (y >= _height)) return;
+  if((x >= _width) || (y >= _height)) {PROFILE_EXIT(); return;}
   if((x + w - 1) >= _width)  w = _width  - x;
   if((y + h - 1) >= _height) h = _height - y;
 
@@ -966,6 +1168,7 @@ void ST7735_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
   }
 
   deselect();
+  PROFILE_EXIT();
 }
 
 //------------ST7735_DrawSmallCircle------------
@@ -984,10 +1187,11 @@ int16_t const smallCircle[6][3]={
   {1  ,  4,  4},
     {2,3,    2}};
 void ST7735_DrawSmallCircle(int16_t x, int16_t y, uint16_t color) {
+  PROFILE_ENTER(ST7735_PROF_CIRCLE);
   uint32_t i,w;
   uint8_t hi = color >> 8, lo = color;
   // rudimentary clipping 
-  if((x>_width-5)||(y>_height-5)) return; // doesn't fit
+  if((x>_width-5)||(y>_height-5)) {PROFILE_EXIT(); return;} // doesn't fit
   for(i=0; i<6; i++){
     setAddrWindow(x+smallCircle[i][0], y+i, x+smallCircle[i][1], y+i);
     w = smallCircle[i][2];
@@ -997,6 +1201,7 @@ void ST7735_DrawSmallCircle(int16_t x, int16_t y, uint16_t color) {
     }
   }
   deselect();
+  PROFILE_EXIT();
 }
 //------------ST7735_DrawCircle------------
 // Draw a small circle (diameter of 10 pixels)
@@ -1018,10 +1223,11 @@ int16_t const circle[10][3]={
     {2   ,    7,     6},
      {  4,5,         2}};
 void ST7735_DrawCircle(int16_t x, int16_t y, uint16_t color) {
+  PROFILE_ENTER(ST7735_PROF_CIRCLE);
   uint32_t i,w;
   uint8_t hi = color >> 8, lo = color;
   // rudimentary clipping 
-  if((x>_width-9)||(y>_height-9)) return; // doesn't fit
+  if((x>_width-9)||(y>_height-9)) {PROFILE_EXIT(); return;} // doesn't fit
   for(i=0; i<10; i++){
     setAddrWindow(x+circle[i][0], y+i, x+circle[i][1], y+i);
     w = circle[i][2];
@@ -1031,6 +1237,7 @@ void ST7735_DrawCircle(int16_t x, int16_t y, uint16_t color) {
     }
   }
   deselect();
+  PROFILE_EXIT();
 }
 
 //------------ST7735_Color565------------
@@ -1074,11 +1281,13 @@ uint16_t ST7735_SwapColor(uint16_t x) {
 // Output: none
 // Must be less than or equal to 128 pixels wide by 160 pixels high
 void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h){
+  PROFILE_ENTER(ST7735_PROF_BITMAP);
   int16_t skipC = 0;                      // non-zero if columns need to be skipped due to clipping
   int16_t originalWidth = w;              // save this value; even if not all columns fit on the screen, the image is still this width in ROM
   int i = w*(h - 1);
 
   if((x >= _width) || ((y - h + 1) >= _height) || ((x + w) <= 0) || (y < 0)){
+    PROFILE_EXIT();
     return;                             // image is totally off the screen, do nothing
   }
   if((w > _width) || (h > _height)){    // image is too wide for the screen, do nothing
@@ -1086,6 +1295,7 @@ void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, i
     //following logic much more complicated, since you can have
     //an image that exceeds multiple boundaries and needs to be
     //clipped on more than one side.
+    PROFILE_EXIT();
     return;
   }
   if((x + w - 1) >= _width){            // image exceeds right of screen
@@ -1122,6 +1332,58 @@ void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, i
   }
 
   deselect();
+  PROFILE_EXIT();
+}
+
+
+//------------ST7735_DrawRLEBitmap------------
+// Displays a palette + run length encoded image, decoding it straight
+// into the SSI0 stream. A run of one color is sent as a fill, with no
+// image reads per pixel, so flat artwork is both smaller and faster
+// than ST7735_DrawBitmap.
+// (x,y) is the screen location of the lower left corner, as in ST7735_DrawBitmap
+// Requires (11 + 2*w*h) bytes of transmission
+// Input: x     horizontal position of the bottom left corner of the image, columns from the left edge
+//        y     vertical position of the bottom left corner of the image, rows from the top edge
+//        image pointer to the encoded image
+// Output: none
+// The image must fit entirely on the screen, otherwise nothing is drawn
+void ST7735_DrawRLEBitmap(int16_t x, int16_t y, const RLEBitmap *image){
+  PROFILE_ENTER(ST7735_PROF_RLEBITMAP);
+  int16_t w = image->width;
+  int16_t h = image->height;
+  uint32_t remaining = (uint32_t)w*h;  // never send more pixels than the window holds
+  uint32_t i = 0;
+  uint32_t count;
+  uint16_t color;
+  uint8_t hi, lo, run;
+
+  if((x < 0) || ((y - h + 1) < 0) || ((x + w) > _width) || (y >= _height)){
+    PROFILE_EXIT();
+    return;                             // not entirely on the screen
+  }
+
+  setAddrWindow(x, y-h+1, x+w-1, y);
+
+  while((i < image->numRuns) && remaining){
+    run = image->runs[i++];
+    count = (run >> 4) + 1;
+    if((count == 16) && (i < image->numRuns)){
+      count = count + image->runs[i++];   // long run, extension byte
+    }
+    if(count > remaining) count = remaining;
+    remaining = remaining - count;
+    color = image->palette[run & 0x0F];
+    hi = color >> 8;
+    lo = color;
+    while(count--){
+      writedata(hi);
+      writedata(lo);
+    }
+  }
+
+  deselect();
+  PROFILE_EXIT();
 }
 
 
@@ -1141,13 +1403,16 @@ void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, i
 //        size      number of pixels per character pixel (e.g. size==2 prints each pixel of font as 2x2 square)
 // Output: none
 void ST7735_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t bgColor, uint8_t size){
+  PROFILE_ENTER(ST7735_PROF_CHAR);
   uint8_t line; // vertical column of pixels of character in font
   int32_t i, j;
   if((x >= _width)            || // Clip right
      (y >= _height)           || // Clip bottom
      ((x + 6 * size - 1) < 0) || // Clip left
-     ((y + 8 * size - 1) < 0))   // Clip top
+     ((y + 8 * size - 1) < 0)){  // Clip top
+    PROFILE_EXIT();
     return;
+  }
 
   for (i=0; i<6; i++ ) {
     if (i == 5)
@@ -1171,6 +1436,7 @@ void ST7735_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t b
       line >>= 1;
     }
   }
+  PROFILE_EXIT();
 }
 
 
@@ -1188,12 +1454,14 @@ void ST7735_DrawCharS(int16_t x, int16_t y, char c, int16_t textColor, int16_t b
 //        size      number of pixels per character pixel (e.g. size==2 prints each pixel of font as 2x2 square)
 // Output: none
 void ST7735_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t bgColor, uint8_t size){
+  PROFILE_ENTER(ST7735_PROF_CHAR);
   uint8_t line; // horizontal row of pixels of character
   int32_t col, row, i, j;// loop indices
   if(((x + 6*size - 1) >= _width)  || // Clip right
      ((y + 8*size - 1) >= _height) || // Clip bottom
      ((x + 6*size - 1) < 0)        || // Clip left
      ((y + 8*size - 1) < 0)){         // Clip top
+    PROFILE_EXIT();
     return;
   }
 
@@ -1226,6 +1494,7 @@ void ST7735_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t bg
   }
 
   deselect();
+  PROFILE_EXIT();
 }
 //------------ST7735_DrawString------------
 // String draw function.
@@ -1238,15 +1507,17 @@ void ST7735_DrawChar(int16_t x, int16_t y, char c, int16_t textColor, int16_t bg
 // bgColor is Black and size is 1
 // Output: number of characters printed
 uint32_t ST7735_DrawString(uint16_t x, uint16_t y, char *pt, int16_t textColor){
+  PROFILE_ENTER(ST7735_PROF_STRING);
   uint32_t count = 0;
-  if(y>15) return 0;
+  if(y>15) {PROFILE_EXIT(); return 0;}
   while(*pt){
     ST7735_DrawCharS(x*6, y*10, *pt, textColor, ST7735_BLACK, 1);
     pt++;
     x = x+1;
-    if(x>20) return count;  // number of characters printed
+    if(x>20) {PROFILE_EXIT(); return count;}  // number of characters printed
     count++;
   }
+  PROFILE_EXIT();
   return count;  // number of characters printed
 }
 
@@ -1581,6 +1852,112 @@ void ST7735_PlotNextErase(void){
   ST7735_DrawFastVLine(X,32,128,ST7735_Color565(228,228,228));
 }
 
+// *************** strip chart ********************
+// Continuously scrolling plot that uses the controller's vertical
+// scroll. Rows 0 to 31 stay fixed for labels, rows 32 to 159 are the
+// scroll area. Time runs down the screen: each new sample is written
+// into the row that just scrolled off the top, and VSCSAD is moved one
+// row so that row reappears at the bottom. A sample costs one
+// 128 pixel row (11+256 bytes) plus 3 bytes of scroll command.
+// Assumes rotation 0 as set by ST7735_InitR. Nothing else may draw in
+// rows 32 to 159 until ST7735_StripChartStop is called, because screen
+// rows no longer match memory rows while scrolled.
+#define STRIP_TOP      32          // first scrolling row
+#define STRIP_ROWS     128         // rows in the scroll area
+#define ST7735_GRAMHEIGHT 162      // rows of controller memory, some hidden
+int32_t StripYmin, StripYrange;
+int32_t StripOffset;               // scroll offset 0 to 127
+int32_t StripLastX;
+uint16_t StripColor, StripBgColor;
+
+void static writeScrollStart(int32_t offset){
+  uint32_t start = STRIP_TOP + RowStart + offset;
+  writecommand(ST7735_VSCSAD);
+  writedata(start >> 8);
+  writedata(start);
+  deselect();
+}
+
+// *************** ST7735_StripChartInit ********************
+// Clear the scroll area and start a scrolling strip chart
+// Inputs: ymin and ymax are range of the plot, mapped left to right
+//         color is the trace color, bgColor the background
+// Outputs: none
+void ST7735_StripChartInit(int32_t ymin, int32_t ymax, uint16_t color, uint16_t bgColor){
+  PROFILE_ENTER(ST7735_PROF_STRIPCHART);
+  uint32_t top = STRIP_TOP + RowStart;
+  uint32_t bottom = ST7735_GRAMHEIGHT - top - STRIP_ROWS;
+  if(ymax < ymin){ int32_t t = ymin; ymin = ymax; ymax = t; }
+  StripYmin = ymin;
+  StripYrange = (ymax > ymin) ? (ymax - ymin) : 1;
+  StripColor = color;
+  StripBgColor = bgColor;
+  StripOffset = 0;
+  StripLastX = -1;
+  ST7735_FillRect(0, STRIP_TOP, ST7735_TFTWIDTH, STRIP_ROWS, bgColor);
+  writecommand(ST7735_VSCRDEF);           // top fixed, scroll area, bottom fixed
+  writedata(top >> 8);
+  writedata(top);
+  writedata(STRIP_ROWS >> 8);
+  writedata(STRIP_ROWS);
+  writedata(bottom >> 8);
+  writedata(bottom);
+  deselect();
+  writeScrollStart(0);
+  PROFILE_EXIT();
+}
+
+// *************** ST7735_StripChartPlot ********************
+// Scroll the chart up one row and draw the new sample in the bottom row,
+// with a horizontal segment joining it to the previous sample
+// Inputs: y is the value to plot, clipped to the range given at init
+// Outputs: none
+void ST7735_StripChartPlot(int32_t y){
+  PROFILE_ENTER(ST7735_PROF_STRIPCHART);
+  int32_t x, i, from, to;
+  uint8_t row;
+  if(y < StripYmin) y = StripYmin;
+  if(y > StripYmin + StripYrange) y = StripYmin + StripYrange;
+  x = ((ST7735_TFTWIDTH - 1)*(y - StripYmin))/StripYrange;
+  if(StripLastX < 0) StripLastX = x;
+  from = (x < StripLastX) ? x : StripLastX;
+  to = (x < StripLastX) ? StripLastX : x;
+  // the oldest row, at the top of the scroll area, becomes the newest
+  row = STRIP_TOP + StripOffset;
+  setAddrWindow(0, row, ST7735_TFTWIDTH - 1, row);
+  for(i = 0; i < ST7735_TFTWIDTH; i++){
+    pushColor(((i >= from) && (i <= to)) ? StripColor : StripBgColor);
+  }
+  deselect();
+  StripOffset = (StripOffset + 1) % STRIP_ROWS;
+  writeScrollStart(StripOffset);
+  StripLastX = x;
+  PROFILE_EXIT();
+}
+
+// *************** ST7735_StripChartStop ********************
+// Leave scrolling mode so normal drawing addresses match the screen again
+// The scroll area contents are left rotated, so callers normally redraw it
+// Inputs: none
+// Outputs: none
+void ST7735_StripChartStop(void){
+  PROFILE_ENTER(ST7735_PROF_STRIPCHART);
+  StripOffset = 0;
+  writecommand(ST7735_VSCRDEF);           // whole memory scrolls, so start 0 is inside it
+  writedata(0);
+  writedata(0);
+  writedata(ST7735_GRAMHEIGHT >> 8);
+  writedata(ST7735_GRAMHEIGHT);
+  writedata(0);
+  writedata(0);
+  writecommand(ST7735_VSCSAD);
+  writedata(0);
+  writedata(0);
+  writecommand(ST7735_NORON);             // normal display mode ends scrolling
+  deselect();
+  PROFILE_EXIT();
+}
+
 // Used in all the plots to write buffer to LCD
 // Example 1 Voltage versus time
 //    ST7735_PlotClear(0,4095);  // range from 0 to 4095
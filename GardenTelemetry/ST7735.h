@@ -119,6 +119,19 @@ enum initRFlags{
 #define ST7735_TFTWIDTH  128
 #define ST7735_TFTHEIGHT 160
 
+// uncomment to copy every byte sent on SSI0 to UART0 as text, one line
+// per command ("C2A 00 00 00 7F"), for Tools/st7735emu.py to render
+// very slow, a full screen fill takes over ten seconds at 115200 baud
+// UART0 must be initialized before ST7735_InitR. The trace is queued
+// behind DEBUG1 text, but text printed from an interrupt can still split
+// a command line, so capture golden traces with DEBUG1 off.
+//#define ST7735_TRACE
+
+// uncomment to count SSI0 bytes, address windows and time spent waiting
+// on SSI0, per drawing primitive and per caller supplied tag
+//#define ST7735_PROFILE
+#define ST7735_PROFILE_TAGS 32     // tags 0 to 31, 0 when no caller set one
+
 
 // Color definitions
 #define ST7735_BLACK   0x0000
@@ -169,6 +182,37 @@ void ST7735_DrawPixel(int16_t x, int16_t y, uint16_t color);
 void ST7735_DrawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
 
 
+//------------ST7735_DrawColumnBits------------
+// Draw a run of pixels down one column in a single address window, each
+// pixel colored by one bit of a bit array (1 = fgColor, 0 = bgColor).
+// Requires (11 + 2*h) bytes of transmission (assuming image fully on screen)
+// Input: x        horizontal position of the column, columns from the left edge
+//        y        vertical position of the first pixel, rows from the top edge
+//        h        number of pixels to draw
+//        bits     bit array, bit n is word n/32, bit n%32
+//        firstBit index of the bit used for the pixel at row y
+//        fgColor  16-bit color for set bits
+//        bgColor  16-bit color for clear bits
+// Output: none
+void ST7735_DrawColumnBits(int16_t x, int16_t y, int16_t h, const uint32_t *bits, int16_t firstBit, uint16_t fgColor, uint16_t bgColor);
+
+
+//------------ST7735_DrawBitColumns------------
+// Draw a block of pixels in a single address window, each column given
+// by one word of bits (bit n is the pixel n rows below y, 1 = fgColor,
+// 0 = bgColor), so a strip of short columns costs one window.
+// Requires (11 + 2*w*h) bytes of transmission (assuming image fully on screen)
+// Input: x        horizontal position of the left column, columns from the left edge
+//        y        vertical position of the top row, rows from the top edge
+//        w        number of columns, words in columns
+//        h        number of rows, 1 to 32
+//        columns  one word per column, left column first
+//        fgColor  16-bit color for set bits
+//        bgColor  16-bit color for clear bits
+// Output: none
+void ST7735_DrawBitColumns(int16_t x, int16_t y, int16_t w, int16_t h, const uint32_t *columns, uint16_t fgColor, uint16_t bgColor);
+
+
 //------------ST7735_DrawFastHLine------------
 // Draw a horizontal line at the given coordinates with the given width and color.
 // A horizontal line is parallel to the shorter side of the rectangular display
@@ -256,6 +300,32 @@ uint16_t ST7735_SwapColor(uint16_t x) ;
 // Must be less than or equal to 128 pixels wide by 160 pixels high
 void ST7735_DrawBitmap(int16_t x, int16_t y, const uint16_t *image, int16_t w, int16_t h);
 
+// Palette + run length encoded image, generated from PNG by Tools/bmpconvert.py
+// Rows are stored top to bottom. Each run byte holds a palette index in
+// the low nibble and the run length-1 in the high nibble; a high nibble
+// of 15 means the next byte adds 0 to 255 more pixels.
+typedef struct{
+  uint16_t width;
+  uint16_t height;
+  const uint16_t *palette;   // up to 16 colors, same format as ST7735_Color565()
+  const uint8_t *runs;
+  uint16_t numRuns;          // bytes in runs[]
+} RLEBitmap;
+
+//------------ST7735_DrawRLEBitmap------------
+// Displays a palette + run length encoded image, decoding it straight
+// into the SSI0 stream. A run of one color is sent as a fill, with no
+// image reads per pixel, so flat artwork is both smaller and faster
+// than ST7735_DrawBitmap.
+// (x,y) is the screen location of the lower left corner, as in ST7735_DrawBitmap
+// Requires (11 + 2*w*h) bytes of transmission
+// Input: x     horizontal position of the bottom left corner of the image, columns from the left edge
+//        y     vertical position of the bottom left corner of the image, rows from the top edge
+//        image pointer to the encoded image
+// Output: none
+// The image must fit entirely on the screen, otherwise nothing is drawn
+void ST7735_DrawRLEBitmap(int16_t x, int16_t y, const RLEBitmap *image);
+
 //------------ST7735_DrawCharS------------
 // Simple character draw function.  This is the same function from
 // Adafruit_GFX.c but adapted for this processor.  However, each call
@@ -401,6 +471,69 @@ void ST7735_PlotNext(void);
 // Outputs: none
 void ST7735_PlotNextErase(void);
 
+// *************** ST7735_StripChartInit ********************
+// Clear rows 32 to 159 and start a strip chart that scrolls in hardware
+// Each sample costs one 128 pixel row instead of a full redraw
+// Inputs: ymin and ymax are range of the plot, mapped left to right
+//         color is the trace color, bgColor the background
+// Outputs: none
+void ST7735_StripChartInit(int32_t ymin, int32_t ymax, uint16_t color, uint16_t bgColor);
+
+// *************** ST7735_StripChartPlot ********************
+// Scroll the chart up one row and draw the new sample in the bottom row
+// Inputs: y is the value to plot
+// Outputs: none
+void ST7735_StripChartPlot(int32_t y);
+
+// *************** ST7735_StripChartStop ********************
+// Leave scrolling mode, must be called before drawing in rows 32 to 159
+// with any other function
+// Inputs: none
+// Outputs: none
+void ST7735_StripChartStop(void);
+
+//------------ST7735_ProfileTag------------
+// Charges the SSI0 traffic that follows to a tag, until the next call
+// Does nothing unless ST7735_PROFILE is defined
+// Input: tag   0 to ST7735_PROFILE_TAGS-1, larger values are counted as the last tag
+// Output: none
+
+//------------ST7735_ProfileReport------------
+// Prints the counts since the last report on UART0 as CSV, one line per
+// primitive and per tag that sent anything, then clears them.
+// Time waiting is in bus cycles and needs SysTick running (SysTick_Init).
+// A call is counted for the outermost primitive only, so the pixels a
+// string draws count toward DrawString rather than DrawPixel.
+// Does nothing unless ST7735_PROFILE is defined
+// Input: none
+// Output: none
+
+//------------ST7735_ProfileBytes------------
+// Total bytes sent over SSI0 since reset, not cleared by ST7735_ProfileReport
+// Always 0 unless ST7735_PROFILE is defined
+// Input: none
+// Output: byte count, wraps at 2^32
+#ifdef ST7735_PROFILE
+void ST7735_ProfileTag(uint32_t tag);
+void ST7735_ProfileReport(void);
+uint32_t ST7735_ProfileBytes(void);
+#else
+#define ST7735_ProfileTag(tag)
+#define ST7735_ProfileReport()
+#define ST7735_ProfileBytes() 0
+#endif
+
+//------------ST7735_TraceFrame------------
+// Marks the end of a frame in the SSI0 trace, so the emulator saves an image
+// Does nothing unless ST7735_TRACE is defined
+// Input: none
+// Output: none
+#ifdef ST7735_TRACE
+void ST7735_TraceFrame(void);
+#else
+#define ST7735_TraceFrame()
+#endif
+
 // Used in all the plots to write buffer to LCD
 // Example 1 Voltage versus time
 //    ST7735_PlotClear(0,4095);  // range from 0 to 4095
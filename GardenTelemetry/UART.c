@@ -209,12 +209,30 @@ char UART_InCharNonBlock(void){
 }
 // output ASCII character to UART
 // spin if TxFifo is full
+uint32_t UARTBytesOut = 0;       // characters given to UART_OutChar since reset
 void UART_OutChar(char data){
+  UARTBytesOut++;
   while(TxFifo_Put(data) == FIFOFAIL){};
   UART0_IM_R &= ~UART_IM_TXIM;          // disable TX FIFO interrupt
   copySoftwareToHardware();
   UART0_IM_R |= UART_IM_TXIM;           // enable TX FIFO interrupt
 }
+uint32_t UART_OutCount(void){
+  return UARTBytesOut;
+}
+// output ASCII character to UART after everything UART_OutChar queued,
+// polling the hardware FIFO, so it can be called with interrupts disabled
+void UART_OutCharPolled(char data){
+  long sr = StartCritical();
+  UARTBytesOut++;
+  while(TxFifo_Size() > 0){             // earlier output goes first
+    while(UART0_FR_R&UART_FR_TXFF){};
+    copySoftwareToHardware();
+  }
+  while(UART0_FR_R&UART_FR_TXFF){};
+  UART0_DR_R = data;
+  EndCritical(sr);
+}
 // at least one of three things has happened:
 // hardware TX FIFO goes from 3 to 2 or less items
 // hardware RX FIFO goes from 1 to 2 or more items
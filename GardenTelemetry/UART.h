@@ -58,6 +58,19 @@ char UART_InCharNonBlock(void);
 // Output: none
 void UART_OutChar(char data);
 
+//------------UART_OutCount------------
+// Number of characters output by UART_OutChar since reset
+// Input: none
+// Output: count, wraps at 2^32
+uint32_t UART_OutCount(void);
+
+//------------UART_OutCharPolled------------
+// Output 8-bit to serial port behind anything UART_OutChar has queued,
+// without waiting on the software FIFO, so it works with interrupts disabled
+// Input: letter is an 8-bit ASCII character to be transferred
+// Output: none
+void UART_OutCharPolled(char data);
+
 //------------UART_OutString------------
 // Output String (NULL termination)
 // Input: pointer to a NULL-terminated string to be transferred
@@ -0,0 +1,231 @@
+// bench.c
+// Runs on TM4C123
+// Microbenchmarks of the firmware hot paths. Each benchmark is a short
+// function doing one operation, called a fixed number of times between
+// two reads of the DWT cycle counter. The bytes sent to the LCD and to
+// UART0 are counted over the same calls, so a change that saves cycles
+// by moving traffic elsewhere still shows up.
+// The uplink benchmarks queue a message and empty the transmit tiers
+// again. The UART5 transmitter is off while they run and its FIFO is
+// flushed afterwards, so nothing reaches the ESP8266.
+
+#include <stdint.h>
+#include "bench.h"
+#include "ST7735.h"
+#include "UART.h"
+#include "esp8266.h"
+#include "histogram.h"
+#include "fixed.h"
+#include "clock.h"
+#include "frame.h"
+#include "../inc/tm4c123gh6pm.h"
+
+#ifndef DWT_CYCCNT_R             // Tools/host/hostbench.c brings its own
+#define DEMCR_R      (*((volatile uint32_t *)0xE000EDFC))
+#define DEMCR_TRCENA 0x01000000  // enables the DWT
+#define DWT_CTRL_R   (*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNTENA 0x00000001
+#define DWT_CYCCNT_R (*((volatile uint32_t *)0xE0001004))
+#endif
+
+#define BENCH_MESSAGE "99,1,0.0\n"   // a virtual pin Blynk_to_TM4C ignores
+#define UART5_IRQ_BIT (0x01<<(61-32)) // UART5 in NVIC_EN1_R and NVIC_DIS1_R
+
+void Rx5Fifo_Init(void);         // in esp8266.c
+int Rx5Fifo_Put(char data);      // in esp8266.c
+void Tx5Fifo_Init(void);         // in esp8266.c
+void Blynk_to_TM4C(void);        // in Blynk.c
+void TM4C_to_Blynk(uint32_t pin, uint32_t value);   // in Blynk.c
+extern const RLEBitmap clockBitmap;
+
+typedef struct
+{
+	char *name;
+	void (*run)(void);
+	uint32_t ops;               // calls per measurement
+} Benchmark;
+
+char static BenchRx[ESP8266_MESSAGESIZE];
+Histogram static BenchHistogram;
+int32_t static BenchReading = 0;
+int32_t static BenchHistory[128];
+uint8_t static BenchPayload[FRAME_MAX_PAYLOAD];
+uint8_t static BenchFrame[FRAME_MAX_ENCODED];
+const uint16_t static BenchImage[8*8] = {
+	0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000,
+	0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF,
+	0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000,
+	0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF,
+	0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000,
+	0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF,
+	0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000,
+	0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0xFFFF
+};
+
+void static putMessage(void)
+{
+	char *pt = BENCH_MESSAGE;
+	while(*pt) {Rx5Fifo_Put(*pt++);}
+}
+
+void static benchFifo(void)
+{
+	putMessage();
+	ESP8266_GetMessage(BenchRx);
+}
+
+void static benchParse(void)
+{
+	putMessage();
+	Blynk_to_TM4C();
+}
+
+// one reading to the app, as SendInformation sends it
+void static benchSendPin(void)
+{
+	TM4C_to_Blynk(74, 1234);
+	Tx5Fifo_Init();
+}
+
+// the longest number ESP8266_OutUDec writes, as a line of its own
+void static benchOutUDec(void)
+{
+	ESP8266_OutUDec(4294967295u);
+	ESP8266_OutChar('\n');
+	Tx5Fifo_Init();
+}
+
+void static benchHistogramPut(void)
+{
+	BenchReading = (BenchReading + 37) & 0x0FFF;	//walks the whole ADC range
+	Histogram_Put(&BenchHistogram, BenchReading);
+}
+
+void static benchHistogramPlot(void)
+{
+	ST7735_PlotClear(0, BenchHistogram.maxCount);
+	for(int i = 0; i < HISTOGRAM_MAX_BINS; i++)
+	{
+		uint32_t count = Histogram_Bin(&BenchHistogram, i);
+		if(count) {ST7735_PlotBar(count);}
+		ST7735_PlotNext();
+	}
+}
+
+// a full raw history of one sensor, as sendHistory does it in Blynk.c
+void static benchBatch(void)
+{
+	uint32_t next = 0, used;
+	while(next < 128)
+	{
+		uint32_t size = Frame_PutBatch(BenchPayload, 70, 500, &BenchHistory[next], 128 - next, &used);
+		Frame_Encode(BenchPayload, size, BenchFrame);
+		next += used;
+	}
+}
+
+void static benchTime(void)
+{
+	displayCurrentTime(12, 59, 59, "pm");
+}
+
+void static benchChar(void)
+{
+	ST7735_DrawCharS(0, 0, '8', ST7735_YELLOW, ST7735_BLACK, 1);
+}
+
+void static benchString(void)
+{
+	ST7735_DrawString(0, 1, "12:59:59 pm", ST7735_YELLOW);
+}
+
+void static benchFillRect(void)
+{
+	ST7735_FillRect(0, 20, 10, 10, ST7735_BLUE);
+}
+
+void static benchBitmap(void)
+{
+	ST7735_DrawBitmap(0, 47, BenchImage, 8, 8);
+}
+
+void static benchRLEBitmap(void)
+{
+	ST7735_DrawRLEBitmap(32, 127, &clockBitmap);
+}
+
+void static benchLine(void)
+{
+	ST7735_Line(0, 0, 127, 159, ST7735_WHITE);
+}
+
+const Benchmark static Benchmarks[] = {
+	{"rx_fifo", &benchFifo, 100},
+	{"blynk_parse", &benchParse, 100},
+	{"blynk_send", &benchSendPin, 100},
+	{"esp_out_udec", &benchOutUDec, 100},
+	{"histogram_put", &benchHistogramPut, 1000},
+	{"histogram_plot", &benchHistogramPlot, 4},
+	{"batch_encode_128", &benchBatch, 10},
+	{"display_time", &benchTime, 1000},
+	{"draw_char", &benchChar, 100},
+	{"draw_string", &benchString, 20},
+	{"fill_rect", &benchFillRect, 100},
+	{"draw_bitmap", &benchBitmap, 100},
+	{"draw_rle_bitmap", &benchRLEBitmap, 10},
+	{"line", &benchLine, 20}
+};
+#define NUM_BENCHMARKS (sizeof(Benchmarks)/sizeof(Benchmarks[0]))
+
+void static printPerOp(uint32_t total, uint32_t ops)
+{
+	UART_OutUDec((total + ops/2) / ops);
+}
+
+void Bench_Run(void)
+{
+	NVIC_DIS1_R = UART5_IRQ_BIT;		//the receive benchmarks own the FIFO, nothing from the ESP8266 may be mixed in
+	UART5_CTL_R &= ~UART_CTL_TXE;		//what the uplink benchmarks queue stays in the hardware FIFO
+	DEMCR_R |= DEMCR_TRCENA;
+	DWT_CYCCNT_R = 0;
+	DWT_CTRL_R |= DWT_CYCCNTENA;
+	Histogram_Init(&BenchHistogram, HISTOGRAM_MAX_BINS, 1);
+	for(uint32_t i = 0; i < 128; i++)
+	{
+		BenchHistory[i] = 2000 + (int32_t)(i % 7) - 3;	//slow sensor, steps of a few counts
+	}
+#ifdef ST7735_PROFILE
+	UART_OutString("bench,ops,cycles_per_op,lcd_bytes_per_op,uart_bytes_per_op\r\n");
+#else
+	UART_OutString("bench,ops,cycles_per_op,uart_bytes_per_op\r\n");
+#endif
+	for(uint32_t i = 0; i < NUM_BENCHMARKS; i++)
+	{
+		const Benchmark *b = &Benchmarks[i];
+		uint32_t lcd = ST7735_ProfileBytes();
+		uint32_t uart = UART_OutCount();
+		uint32_t start = DWT_CYCCNT_R;
+		for(uint32_t n = 0; n < b->ops; n++) {b->run();}
+		uint32_t cycles = DWT_CYCCNT_R - start;
+		lcd = ST7735_ProfileBytes() - lcd;
+		uart = UART_OutCount() - uart;
+		UART_OutString(b->name); UART_OutChar(',');
+		UART_OutUDec(b->ops); UART_OutChar(',');
+		printPerOp(cycles, b->ops); UART_OutChar(',');
+#ifdef ST7735_PROFILE
+		printPerOp(lcd, b->ops); UART_OutChar(',');
+#else
+		(void)lcd;
+#endif
+		printPerOp(uart, b->ops);
+		UART_OutString("\r\n");
+	}
+	ST7735_FillScreen(ST7735_BLACK);
+	UART5_CTL_R &= ~UART_CTL_UARTEN;	//clearing FEN flushes the transmit FIFO
+	UART5_LCRH_R &= ~UART_LCRH_FEN;
+	UART5_LCRH_R |= UART_LCRH_FEN;
+	UART5_CTL_R |= (UART_CTL_TXE|UART_CTL_UARTEN);
+	Tx5Fifo_Init();
+	Rx5Fifo_Init();
+	NVIC_EN1_R = UART5_IRQ_BIT;
+}
@@ -0,0 +1,28 @@
+// bench.h
+// Runs on TM4C123
+// Microbenchmarks of the firmware hot paths, timed with the Cortex-M4
+// DWT cycle counter and printed on UART0 as CSV:
+//   bench,ops,cycles_per_op,lcd_bytes_per_op,uart_bytes_per_op
+// The lcd_bytes_per_op column is only there when ST7735_PROFILE is
+// defined in ST7735.h. Needs UART0 (DEBUG1 in esp8266.h) and UART5
+// (ESP8266_Init), and runs before the ESP8266 is reset and the timers
+// are started, so nothing else competes for the CPU. The UART5 interrupt
+// and transmitter are held off while it runs and both FIFOs are emptied
+// afterwards. The benchmarks draw on the LCD.
+// Tools/host/hostbench.c runs the same benchmarks on a PC.
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+// uncomment to run the benchmarks once at startup
+//#define BENCHMARK
+
+//------------Bench_Run------------
+// Runs every benchmark and prints one CSV line for each
+// Inputs:  none
+// Outputs: none
+void Bench_Run(void);
+
+#endif
@@ -1,15 +1,18 @@
-#include <stdio.h>
 #include "clock.h"
-#include <math.h>
 #include "ST7735.h" //driver for the LCD
 #include "fixed.h"  //public definitions of our fixed point functions
 #include "bitmaps.h"
+#include "clockHands.h" //precomputed hand endpoints, see Tools/handtable.py
 #include "PWM.h"
 #include "Timer.h"
+#include "histogram.h"
+#include "qformat.h"
+#include "ui.h"
+#include "dashboard.h"
+#include "events.h"
 #include "../inc/tm4c123gh6pm.h"
 
 #define HAND_COLOR ST7735_WHITE
-#define PI 3.14159265
 #define map(input, minFirst, maxFirst, minSecond, maxSecond) ((input - minFirst) * (maxSecond - minSecond) / (maxFirst - minFirst) + minSecond)
 
 #define TIME_X_CURSOR 6
@@ -21,25 +24,35 @@
 #define ALARM_X 5
 #define ALARM_Y 14
 
+#define TITLE_WIDTH 16
+#define TIME_WIDTH 10
+#define ALARM_WIDTH 9
+
 #define MAX_SAMPLES 20
-int dataBuffer[MAX_SAMPLES];
-int PMFbuffer[4097];
+#define GRAPH_BINS 128		//one bin per plot column
+Histogram sensorHistogram;		//set up by initSensorGraph
 int dataBufferIndex = 0;
 int currentSensor = 0;
 
 #define CLOCK_TITLE "Clock Mode"
 #define SET_ALARM_TITLE "Setting Alarm"
 #define GRAPH_SENSORS_TITLE "Sensor Readings"
+#define STRIP_CHART_TITLE "Sensor Trace"
 
 int currentMode = CLOCK_MODE;
 int lastMode = CLOCK_MODE;
 int initMode = 1;
 
-const int HOUR_HAND_SIZE = 17;
-const int MINUTE_HAND_SIZE = 	25;
 int clockOrigin[2];
 int clockCenter[2];
 
+char timeText[TIME_WIDTH + 1];		//"hh:mm:ssam" plus null
+char alarmText[ALARM_WIDTH + 1] = "";
+int32_t handPosition = 0;		//minutes past 12:00 the face was last asked to show
+int32_t histogramFrame = 0;		//bumped each time a full histogram is ready
+int stripReading = 0;
+int stripFresh = 0;		//set by putStripSample, cleared once the row is drawn
+
 int minutes = 30;
 int seconds = 40;
 int hours = 11;
@@ -48,9 +61,11 @@ int timerHours = 0;
 int timerMinutes = 3;
 int timerSeconds = 0;
 
-int prevHours =  11;
-int prevMinutes = 59;
-int prevSeconds = 50;
+//the time of day in seconds since midnight. Timer0 advances it in every
+//mode, hours, minutes, seconds and merridian show it only on the clock
+//screen and hold the alarm on the alarm screen
+int32_t volatile timeOfDay = 11*3600 + 59*60 + 50;
+int static timeRunning = 0;		//Timer0 is started by the first clockMode
 
 int topHours = 0;
 int topMinutes = 3;
@@ -67,7 +82,6 @@ char am[] = "am";
 char pm[] = "pm";
 char *merridian = am;
 char *alarmMerridian = pm;
-char *prevMerridian = am;
 
 int getMode()
 {
@@ -76,25 +90,103 @@ int getMode()
 
 void setMode(int newMode)
 {
-	if(newMode != currentMode) {initMode = 1; lastMode = currentMode;}
+	if(newMode != currentMode) {initMode = 1; lastMode = currentMode; Event_Post(EVENT_MODE);}
 	currentMode = newMode;
 }
 
+//copies the time of day into the digits the clock screen shows and edits
+void static showTimeOfDay(void)
+{
+	int hourOfDay = timeOfDay / 3600;
+	hours = (hourOfDay % 12 == 0) ? 12 : hourOfDay % 12;
+	merridian = (hourOfDay < 12) ? am : pm;
+	minutes = timeOfDay / 60 % 60;
+	seconds = timeOfDay % 60;
+}
+
+//an edit of the clock screen's digits sets the time of day, on the alarm
+//screen they are the alarm and elsewhere nothing
+void static keepTimeOfDay(void)
+{
+	if(lastMode != CLOCK_MODE) {return;}
+	int hourOfDay = hours % 12;
+	if(merridian[0] == 'p') {hourOfDay += 12;}
+	timeOfDay = hourOfDay*3600 + minutes*60 + seconds;
+}
+
+//saves the alarm being shown when leaving the alarm screen for a screen
+//that does not show the time, the time of day keeps running by itself
+void static leaveTimeMode(void)
+{
+	if(lastMode == SET_ALARM_MODE)
+	{
+		alarmHours = hours;
+		alarmMinutes = minutes;
+		alarmSeconds = seconds;
+	}
+}
+
+//the strip chart scrolls rows 32 to 159, so the next screen starts from a
+//normal display and a blank ui
+void static leaveStripChart(void)
+{
+	if(lastMode == STRIP_CHART_MODE)
+	{
+		ST7735_StripChartStop();
+		Ui_Clear();
+	}
+}
+
 void printModeTitle(char *title)
 {
 	ST7735_SetCursor(TITLE_X, TITLE_Y);
 	ST7735_OutString(title);
 }
 
+void static drawClockFace(void)
+{
+	ST7735_DrawRLEBitmap(clockOrigin[0], clockOrigin[1], &clockBitmap);
+	displayClockHands(handPosition / 60, handPosition % 60);
+}
+
+void static drawHistogram(void)
+{
+	ST7735_PlotClear(0, sensorHistogram.maxCount);
+	for(int i = 0; i < GRAPH_BINS; i++)
+	{
+		uint32_t count = Histogram_Bin(&sensorHistogram, i);
+		if(count) {ST7735_PlotBar(count);}
+		ST7735_PlotNext();
+	}
+}
+
+//screens share the title, time and alarm slots so switching between them
+//only repaints the text that changes
+void static showTimeScreen(char *title, int showFace)
+{
+	Ui_Begin();
+	Ui_Label(TITLE_X, TITLE_Y, TITLE_WIDTH, title, ST7735_YELLOW);
+	Ui_Label(TIME_X_CURSOR, TIME_Y_CURSOR, TIME_WIDTH, timeText, ST7735_YELLOW);
+	Ui_Label(ALARM_X, ALARM_Y, ALARM_WIDTH, alarmText, ST7735_YELLOW);
+	if(showFace) {Ui_Region(clockOrigin[0], clockOrigin[1] - clockSize + 1, clockSize, clockSize, &handPosition, &drawClockFace);}
+	Ui_End();
+}
+
+void static showGraphScreen(void)
+{
+	Ui_Begin();
+	Ui_Label(0, 0, TITLE_WIDTH, GRAPH_SENSORS_TITLE, ST7735_YELLOW);
+	Ui_Region(0, 32, 128, 128, &histogramFrame, &drawHistogram);
+	Ui_End();
+}
+
 void clockMode()
 {
 	if(initMode == 1)
 	{
+		leaveStripChart();
 		initMode = 0;
-		ST7735_FillScreen(ST7735_BLACK); 
-		ST7735_SetCursor(0,0);
 		initClock(32, 64);
-		printModeTitle(CLOCK_TITLE);
 		DisableInterrupts();
 		if(lastMode == SET_ALARM_MODE)
 		{
@@ -104,15 +196,13 @@ void clockMode()
 			alarmMerridian = merridian;
 		}
 		lastMode = CLOCK_MODE;
-		hours = prevHours;
-		minutes = prevMinutes;
-		seconds = prevSeconds;
-		merridian = prevMerridian;
-		Timer0_Init(&updateTime, 80000000);
-		ST7735_DrawBitmap(clockOrigin[0], clockOrigin[1], clock, clockSize, clockSize);
-		displayClockHands(hours, minutes);
-		timeChanged = 1;
+		showTimeOfDay();
+		if(!timeRunning) {Timer0_Init(&updateTime, 80000000); timeRunning = 1;}
+		handPosition = (hours % 12) * 60 + minutes;
+		displayCurrentTime(hours, minutes, seconds, merridian);
+		timeChanged = 0;
 		EnableInterrupts();
+		showTimeScreen(CLOCK_TITLE, 1);
 	}
 	//configure clock time
 	if(timeChanged == 1)
@@ -132,43 +222,29 @@ void clockMode()
 		
 	if(minuteChanged)
 	{
-		ST7735_DrawBitmap(clockOrigin[0], clockOrigin[1], clock, clockSize, clockSize);
 		DisableInterrupts();
-		int currentMinutes = minutes;
-		int currentHours = hours;
+		handPosition = (hours % 12) * 60 + minutes;
 		minuteChanged = 0;
 		EnableInterrupts();
-		displayClockHands(currentHours, currentMinutes);
 	}
-		 	
+	Ui_Refresh();
 }
 
 void setAlarmMode()
 {	if(initMode == 1)
 	{
+		leaveStripChart();
 		DisableInterrupts();
-		TIMER0_IMR_R = 0;
 		initMode = 0;
-		ST7735_FillScreen(ST7735_BLACK); 
-		ST7735_SetCursor(0,0);
-		//initClock(32, 64);
-		printModeTitle(SET_ALARM_TITLE);
-		if(lastMode == CLOCK_MODE)
-		{
-			prevHours = hours;
-			prevMinutes = minutes;
-			prevSeconds = seconds;
-			prevMerridian = merridian;
-		}
 		lastMode = SET_ALARM_MODE;
 		hours = alarmHours;
 		minutes = alarmMinutes;
 		seconds = alarmSeconds;
 		merridian = alarmMerridian;
-		//ST7735_DrawBitmap(clockOrigin[0], clockOrigin[1], clock, clockSize, clockSize);
-		//displayClockHands(hours, minutes);
-		timeChanged = 1;
+		displayCurrentTime(hours, minutes, seconds, merridian);
+		timeChanged = 0;
 		EnableInterrupts();
+		showTimeScreen(SET_ALARM_TITLE, 0);
 	}
 	//configure clock time
 	if(timeChanged == 1)
@@ -179,73 +255,81 @@ void setAlarmMode()
 		int currentHours = hours;
 		timeChanged = 0;
 		EnableInterrupts();
-		//ST7735_DrawBitmap(clockOrigin[0], clockOrigin[1], clock, clockSize, clockSize);
 		displayCurrentTime(currentHours, currentMinutes, currentSeconds, merridian);
-		//displayClockHands(currentHours, currentMinutes);
 	}
-		
+	Ui_Refresh();
 }
 
 void graphSensorsMode(void)
 {
 	if(initMode == 1)
 	{
+		leaveStripChart();
 		DisableInterrupts();
 		initMode = 0;
-		if(lastMode == CLOCK_MODE)
-		{
-			TIMER0_IMR_R = 0;
-			prevHours = hours;
-			prevMinutes = minutes;
-			prevSeconds = seconds;
-		}
-		else
-		{
-			alarmHours = hours;
-			alarmMinutes = minutes;
-			alarmSeconds = seconds;
-		}
+		leaveTimeMode();
 		lastMode = GRAPH_SENSORS_MODE;
-		ST7735_FillScreen(ST7735_BLACK); 
-		ST7735_SetCursor(0, 0);
-		ST7735_OutString(GRAPH_SENSORS_TITLE);
+		Histogram_Clear(&sensorHistogram);
+		dataBufferIndex = 0;
 		EnableInterrupts();
+		showGraphScreen();
   }
 	
 	if(dataBufferIndex == MAX_SAMPLES)
 	{
-		  dataBufferIndex = 0;
-		
-			int minADC = 4096;
-			int maxADC = 0;
-			int minPMF = 4096;
-			int maxPMF = 0;
-			
-			
-			for(int i = 0; i < MAX_SAMPLES; i++)
-			{
-				int reading = dataBuffer[i];
-				PMFbuffer[reading] += 1;
-				if(reading > maxADC) {maxADC = reading;}
-				if(reading < minADC) {minADC = reading;}
-				if(PMFbuffer[reading] > maxPMF) {maxPMF = PMFbuffer[reading];}
-				if(PMFbuffer[reading] < minPMF) {minPMF = PMFbuffer[reading];}
-			}
+			//putData stops adding once the frame is full, so the histogram is stable here
+			histogramFrame++;
+			Ui_Refresh();
 			
-			ST7735_PlotClear(minPMF, maxPMF);
-			
-			if(minADC < 50) {minADC = 50;}
-			for(int i = minADC - 50; i <= maxADC; i++)
-			{
-				ST7735_PlotBar(PMFbuffer[i]);
-				ST7735_PlotNext();
-			}
-			for(int i = 0; i < 4097; i++) {PMFbuffer[i] = 0;}
+			DisableInterrupts();
+			Histogram_Clear(&sensorHistogram);
+			dataBufferIndex = 0;
+			EnableInterrupts();
 	}
 	
 	
 }
 
+void dashboardMode(void)
+{
+	if(initMode == 1)
+	{
+		leaveStripChart();
+		DisableInterrupts();
+		initMode = 0;
+		leaveTimeMode();
+		lastMode = DASHBOARD_MODE;
+		EnableInterrupts();
+		Dashboard_Show();
+	}
+	Dashboard_Update();
+}
+
+void stripChartMode(void)
+{
+	if(initMode == 1)
+	{
+		DisableInterrupts();
+		initMode = 0;
+		leaveTimeMode();
+		lastMode = STRIP_CHART_MODE;
+		stripFresh = 0;
+		EnableInterrupts();
+		Ui_Begin();
+		Ui_Label(0, 0, TITLE_WIDTH, STRIP_CHART_TITLE, ST7735_YELLOW);
+		Ui_End();		//erases the old screen before the scroll area is taken over
+		ST7735_StripChartInit(0, 4095, ST7735_GREEN, ST7735_BLACK);
+	}
+	if(stripFresh)
+	{
+		DisableInterrupts();
+		int reading = stripReading;
+		stripFresh = 0;
+		EnableInterrupts();
+		ST7735_StripChartPlot(reading);
+	}
+}
+
 void initClock(int clockX, int clockY)
 {
 	clockOrigin[0] = clockX;
@@ -254,41 +338,86 @@ void initClock(int clockX, int clockY)
 	clockCenter[1] = clockY - (clockSize / 2);
 }
 
+//the setters take values from the app, anything out of range is ignored
 void setMinute(int newMinute)
 {
+	if(newMinute < 0 || newMinute > 59) {return;}
 	DisableInterrupts();
 	minutes = newMinute;
+	keepTimeOfDay();
 	timeChanged = 1;
 	EnableInterrupts();
 }
 
 void setHour(int newHour)
 {
+	if(newHour < 1 || newHour > 12) {return;}
 	DisableInterrupts();
 	hours = newHour;
+	keepTimeOfDay();
 	timeChanged = 1;
 	EnableInterrupts();
 }
 
 void setSecond(int newSeconds)
 {
+	if(newSeconds < 0 || newSeconds > 59) {return;}
 	DisableInterrupts();
 	seconds = newSeconds;
+	keepTimeOfDay();
 	timeChanged = 1;
 	EnableInterrupts();
 }
 
+void initSensorGraph(void)
+{
+	Histogram_Init(&sensorHistogram, GRAPH_BINS, 1);
+	dataBufferIndex = 0;
+}
+
 void setSensor(int newSensor)
 {
 	DisableInterrupts();
 	currentSensor = newSensor;
+	Histogram_Clear(&sensorHistogram);
 	dataBufferIndex = 0;
 	EnableInterrupts();
 }
 
+int getSensor(void)
+{
+	return currentSensor;
+}
+
+void putStripSample(int reading)
+{
+	stripReading = reading;
+	stripFresh = 1;
+}
+
 void putData(int reading)
 {
-	dataBuffer[dataBufferIndex++] = reading;
+	if(dataBufferIndex >= MAX_SAMPLES) {return;}		//frame full, waiting for graphSensorsMode to plot it
+	Histogram_Put(&sensorHistogram, reading);
+	dataBufferIndex++;
+}
+
+void setTimeOfDay(int hourOfDay, int newMinute, int newSecond)
+{
+	DisableInterrupts();
+	timeOfDay = hourOfDay*3600 + newMinute*60 + newSecond;
+	if(lastMode == CLOCK_MODE)
+	{
+		showTimeOfDay();
+		timeChanged = 1;
+		minuteChanged = 1;
+	}
+	EnableInterrupts();
+}
+
+int getHourOfDay(void)
+{
+	return timeOfDay / 3600;
 }
 
 void toggleMerridian()
@@ -296,6 +425,7 @@ void toggleMerridian()
 	DisableInterrupts();
 	if(merridian[0] == 'a' && merridian[1] == 'm') {merridian = pm;}
 	else{merridian = am;}
+	keepTimeOfDay();
 	timeChanged = 1;
 	EnableInterrupts();
 }
@@ -303,39 +433,39 @@ void toggleMerridian()
 void displayClockHands(int currentHours, int currentMinutes)
 {
 	int hourHandEndingPoint[2];
-	calculateHourHandPosition(hourHandEndingPoint, currentHours);
+	calculateHourHandPosition(hourHandEndingPoint, currentHours, currentMinutes);
 	int minuteHandEndingPoint[2];
 	calculateMinuteHandPosition(minuteHandEndingPoint, currentMinutes);
 	ST7735_Line(clockCenter[0], clockCenter[1], minuteHandEndingPoint[0], minuteHandEndingPoint[1], HAND_COLOR);
 	ST7735_Line(clockCenter[0], clockCenter[1], hourHandEndingPoint[0], hourHandEndingPoint[1], HAND_COLOR);
 }
 
-void calculateHourHandPosition(int endingPoint[2], int currentHours)
+//hour hand advances once a minute so it sits between the hour marks
+void calculateHourHandPosition(int endingPoint[2], int currentHours, int currentMinutes)
 {
-	float percentageThrough = currentHours / 12.0;
-	calculateEndingPoint(endingPoint, HOUR_HAND_SIZE, percentageThrough);
+	uint32_t position = ((uint32_t)currentHours % 12) * 60 + ((uint32_t)currentMinutes % 60);	//unsigned, so never a negative index
+	calculateEndingPoint(endingPoint, HourHand[position]);
 }
 
 void calculateMinuteHandPosition(int endingPoint[2], int currentMinutes)
 {
-	float percentageThrough = currentMinutes / 60.0;
-	calculateEndingPoint(endingPoint, MINUTE_HAND_SIZE, percentageThrough);
+	calculateEndingPoint(endingPoint, MinuteHand[(uint32_t)currentMinutes % MINUTE_POSITIONS]);
 }
 
-void calculateEndingPoint(int endingPoint[2], int radius, float percentageThrough)
+void calculateEndingPoint(int endingPoint[2], const int8_t offset[2])
 {
-	float angle = (360.0 * percentageThrough + 90.0) * -1 * PI / 180.0;
-	int x = clockCenter[0] - (cos(angle) * radius);
-	int y = clockCenter[1] +  (sin(angle) * radius); 
-	endingPoint[0] = x;
-	endingPoint[1] = y;
+	endingPoint[0] = clockCenter[0] + offset[0];
+	endingPoint[1] = clockCenter[1] + offset[1];
 }
 
+//called from the Blynk timer, so only the text is stored here and the
+//mode functions repaint it from the main loop
 void printAlarmStatus(char *title)
 {
 	DisableInterrupts();
-	ST7735_SetCursor(ALARM_X, ALARM_Y);
-	ST7735_OutString(title);
+	int i = 0;
+	for(; i < ALARM_WIDTH && title[i]; i++) {alarmText[i] = title[i];}
+	alarmText[i] = 0;
 	EnableInterrupts();
 }
 
@@ -355,52 +485,27 @@ void disableAlarm()
   alarmSet = 0;
 }
 
-void swapMerridian()
-{
-	if(merridian[0] == 'a' && merridian[1] == 'm') {merridian = pm;}
-	else{merridian = am;}
-}
-
 void updateTime()
 {
 	DisableInterrupts();
-	seconds++;
-	if(seconds == 60) {seconds = 0; minutes++; minuteChanged = 1;}
-	if(minutes == 60) {minutes = 0; hours++; if(hours == 12){swapMerridian();};}
-	if(hours == 13) {hours = 1; }
+	timeOfDay = (timeOfDay + 1) % (24*3600);
+	if(lastMode != CLOCK_MODE) {EnableInterrupts(); return;}
+	showTimeOfDay();
+	if(seconds == 0) {minuteChanged = 1;}
 	timeChanged = 1;
 	EnableInterrupts();
+	Event_Post(EVENT_CLOCK);
 }
 
+//formats into timeText, the time label repaints on the next Ui_Refresh
 void displayCurrentTime(int currentHours, int currentMinutes, int currentSeconds, char* merridian)
 {
-			ST7735_SetCursor(TIME_X_CURSOR, TIME_Y_CURSOR);
-			char timeBuffer[10];
-			if(currentHours < 10)
-			{
-				if(currentMinutes < 10) 
-				{
-					if(currentSeconds > 9) {sprintf(timeBuffer, "0%d:0%d:%d%s", currentHours, currentMinutes, currentSeconds, merridian);}
-					else{sprintf(timeBuffer, "0%d:0%d:0%d%s", currentHours, currentMinutes, currentSeconds, merridian);}
-				}
-				else
-				{
-					if(currentSeconds > 9) {sprintf(timeBuffer, "0%d:%d:%d%s", currentHours, currentMinutes, currentSeconds, merridian);}
-					else{sprintf(timeBuffer, "0%d:%d:0%d%s", currentHours, currentMinutes, currentSeconds, merridian);}
-				}
-			}
-			else
-			{
-				if(currentMinutes < 10) 
-				{
-					if(currentSeconds > 9) {sprintf(timeBuffer, "%d:0%d:%d%s", currentHours, currentMinutes, currentSeconds, merridian);}
-					else{sprintf(timeBuffer, "%d:0%d:0%d%s", currentHours, currentMinutes, currentSeconds, merridian);}
-				}
-				else
-				{
-					if(currentSeconds > 9) {sprintf(timeBuffer, "%d:%d:%d%s", currentHours, currentMinutes, currentSeconds, merridian);}
-					else{sprintf(timeBuffer, "%d:%d:0%d%s", currentHours, currentMinutes, currentSeconds, merridian);}
-				}
-			}
-			ST7735_OutString(timeBuffer);
+			int length = Fmt_UDecPad(timeText, currentHours, 2, '0');
+			timeText[length++] = ':';
+			length += Fmt_UDecPad(&timeText[length], currentMinutes, 2, '0');
+			timeText[length++] = ':';
+			length += Fmt_UDecPad(&timeText[length], currentSeconds, 2, '0');
+			timeText[length++] = merridian[0];
+			timeText[length++] = merridian[1];
+			timeText[length] = 0;
 }
@@ -6,6 +6,8 @@
 #define CLOCK_MODE								0
 #define SET_ALARM_MODE					  1
 #define GRAPH_SENSORS_MODE        2
+#define DASHBOARD_MODE            3
+#define STRIP_CHART_MODE          4
 
 static int alarmIsArmed = 0;
 static int alarmVolume = 50;
@@ -27,6 +29,14 @@ void setAlarmMode(void);
 
 void graphSensorsMode(void);
 
+void dashboardMode(void);
+
+//------------stripChartMode------------
+// Scrolls the sensor picked on VP13 down the screen, one row per sample
+// Inputs:  none
+// Outputs: none
+void stripChartMode(void);
+
 void setOffAlarm(void);
 
 void enableAlarm(void);
@@ -42,21 +52,48 @@ void setMinute(int newMinute);
 void setHour(int newHour);
 void toggleMerridian(void);
 
+//------------setTimeOfDay------------
+// Sets the whole time at once, for the bulk time message. Works in every
+// mode, the clock screen shows it when it is next entered
+// Inputs:  hourOfDay  0 to 23
+//          newMinute  0 to 59
+//          newSecond  0 to 59
+// Outputs: none
+void setTimeOfDay(int hourOfDay, int newMinute, int newSecond);
+
+//------------getHourOfDay------------
+// Timer0 keeps the time of day running in every mode, not just on the clock screen
+// Inputs:  none
+// Outputs: current hour, 0 to 23
+int getHourOfDay(void);
+
 void initClock(int clockX, int clockY);
 
+//------------initSensorGraph------------
+// Empties the histogram graphSensorsMode plots, call once before interrupts start
+// Inputs:  none
+// Outputs: none
+void initSensorGraph(void);
+
 void setSensor(int newSensor);
 
+int getSensor(void);
+
 void putData(int reading);
 
+//------------putStripSample------------
+// Hands the strip chart its next sample, called from the sampling interrupt
+// Inputs:  reading  ADC value 0 to 4095
+// Outputs: none
+void putStripSample(int reading);
+
 void displayClockHands(int currentHours, int currentMinutes);
 
-void calculateHourHandPosition(int endingPoint[2], int currentHours);
+void calculateHourHandPosition(int endingPoint[2], int currentHours, int currentMinutes);
 
 void calculateMinuteHandPosition(int endingPoint[2], int currentMinutes);
 
-void calculateSecondHandPosition(int endingPoint[2], int currentSeconds);
-
-void calculateEndingPoint(int endingPoint[2], int radius, float percentageThrough);
+void calculateEndingPoint(int endingPoint[2], const int8_t offset[2]);
 
 #endif
 
@@ -0,0 +1,50 @@
+// Generated by Tools/bmpconvert.py from clock.png, do not edit by hand
+// 64x64, 3 colors, 616 bytes of runs (8192 bytes as raw RGB565)
+
+const uint16_t clockPalette[3] = {
+ 0x0000, 0xFFFF, 0xEED3,
+};
+
+const uint8_t clockRuns[616] = {
+ 0xF0, 0x4B, 0x11, 0x10, 0x31, 0xF0, 0x28, 0x11, 0x00, 0x01, 0x20, 0x11, 0x70, 0x11, 0xF0, 0x0F,
+ 0x01, 0x30, 0x01, 0x70, 0x11, 0x40, 0x11, 0x60, 0x21, 0xF0, 0x0E, 0x11, 0x20, 0x11, 0x70, 0x11,
+ 0x40, 0x01, 0x60, 0x01, 0x00, 0x11, 0xF0, 0x0D, 0x01, 0x00, 0x01, 0x10, 0x01, 0x00, 0x01, 0x70,
+ 0x11, 0x40, 0x01, 0x80, 0x11, 0xF0, 0x0F, 0x01, 0x30, 0x01, 0x70, 0x11, 0x20, 0x11, 0x90, 0x11,
+ 0xF0, 0x0F, 0x01, 0x30, 0x01, 0x70, 0x11, 0x10, 0x01, 0x20, 0x01, 0x70, 0x11, 0xF0, 0x0F, 0x01,
+ 0x30, 0x01, 0x60, 0x91, 0x70, 0x11, 0xF0, 0x0F, 0x01, 0x30, 0x01, 0xF0, 0x09, 0x11, 0xF0, 0x0D,
+ 0x91, 0x40, 0xA2, 0xD0, 0x11, 0x00, 0x21, 0xF0, 0x0D, 0xF2, 0x02, 0x00, 0x02, 0x80, 0x01, 0x20,
+ 0x11, 0xF0, 0x09, 0x12, 0x10, 0x32, 0x30, 0x12, 0x30, 0x52, 0xC0, 0x11, 0xF0, 0x09, 0x42, 0x60,
+ 0x12, 0x60, 0x22, 0xC0, 0x01, 0x70, 0x11, 0x20, 0x01, 0x10, 0x01, 0x80, 0x32, 0x70, 0x12, 0x60,
+ 0x12, 0x00, 0x22, 0x80, 0x01, 0x90, 0x01, 0x10, 0x11, 0x10, 0x11, 0x60, 0x42, 0xF0, 0x01, 0x12,
+ 0x00, 0x32, 0x60, 0x01, 0xA0, 0x01, 0x10, 0x11, 0x10, 0x11, 0x50, 0x12, 0x20, 0x02, 0xF0, 0x06,
+ 0x12, 0x50, 0x01, 0x20, 0x01, 0x70, 0x01, 0x10, 0x11, 0x10, 0x11, 0x40, 0x22, 0x20, 0x02, 0xF0,
+ 0x07, 0x12, 0x30, 0x51, 0x70, 0x01, 0x10, 0x11, 0x10, 0x11, 0x30, 0x12, 0xF0, 0x0E, 0x12, 0x10,
+ 0x12, 0xC0, 0x01, 0x10, 0x11, 0x10, 0x11, 0x30, 0x02, 0xF0, 0x10, 0x32, 0xD0, 0x01, 0x20, 0x01,
+ 0x10, 0x01, 0x30, 0x12, 0xF0, 0x10, 0x22, 0xD0, 0x31, 0x10, 0x11, 0x10, 0x02, 0x10, 0x02, 0xF0,
+ 0x0F, 0x42, 0xF0, 0x09, 0x22, 0xF0, 0x13, 0x12, 0xF0, 0x08, 0x42, 0xF0, 0x12, 0x02, 0xF0, 0x07,
+ 0x12, 0x10, 0x12, 0xF0, 0x12, 0x12, 0xF0, 0x06, 0x12, 0xF0, 0x16, 0x12, 0xF0, 0x06, 0x02, 0xF0,
+ 0x18, 0x12, 0xF0, 0x05, 0x02, 0xF0, 0x18, 0x12, 0x40, 0x21, 0x40, 0x21, 0x40, 0x02, 0xF0, 0x18,
+ 0x12, 0x60, 0x11, 0x20, 0x01, 0x10, 0x11, 0x30, 0x02, 0xF0, 0x18, 0x12, 0x60, 0x11, 0x20, 0x01,
+ 0x20, 0x01, 0x30, 0x02, 0xF0, 0x02, 0x42, 0xF0, 0x01, 0x12, 0x40, 0x31, 0x20, 0x01, 0x20, 0x01,
+ 0x00, 0x62, 0xE0, 0x02, 0x10, 0x12, 0xE0, 0x52, 0x50, 0x01, 0x30, 0x11, 0x00, 0x01, 0x00, 0x62,
+ 0xE0, 0x02, 0x10, 0x12, 0xE0, 0x52, 0x50, 0x01, 0x60, 0x01, 0x30, 0x02, 0xF0, 0x02, 0x42, 0xF0,
+ 0x01, 0x12, 0x70, 0x01, 0x40, 0x11, 0x40, 0x02, 0xF0, 0x18, 0x12, 0x30, 0x31, 0x40, 0x01, 0x60,
+ 0x02, 0xF0, 0x18, 0x12, 0xF0, 0x05, 0x02, 0xF0, 0x18, 0x12, 0xF0, 0x05, 0x02, 0xF0, 0x18, 0x12,
+ 0xF0, 0x05, 0x12, 0xF0, 0x16, 0x12, 0xF0, 0x06, 0x22, 0x10, 0x12, 0xF0, 0x0D, 0x12, 0x10, 0x12,
+ 0xF0, 0x07, 0x12, 0x00, 0x22, 0xF0, 0x0D, 0x42, 0xF0, 0x08, 0x42, 0xF0, 0x10, 0x22, 0xF0, 0x00,
+ 0x01, 0x20, 0x01, 0x00, 0x42, 0xF0, 0x12, 0x12, 0x00, 0x22, 0xC0, 0x01, 0x20, 0x01, 0x00, 0x12,
+ 0x10, 0x12, 0xF0, 0x10, 0x22, 0x20, 0x02, 0x20, 0x01, 0x80, 0x31, 0x60, 0x02, 0xF0, 0x10, 0x12,
+ 0x70, 0x01, 0x90, 0x21, 0x60, 0x12, 0xF0, 0x0E, 0x12, 0x70, 0x11, 0x80, 0x01, 0x10, 0x11, 0x60,
+ 0x22, 0x30, 0x12, 0xE0, 0x12, 0x30, 0x12, 0x70, 0x01, 0x00, 0x01, 0x80, 0x01, 0x20, 0x01, 0x70,
+ 0x12, 0x30, 0x12, 0xF0, 0x00, 0x12, 0x10, 0x12, 0x70, 0x01, 0x10, 0x01, 0x80, 0x11, 0x10, 0x01,
+ 0x80, 0x22, 0x10, 0x02, 0xF0, 0x01, 0x52, 0x70, 0x51, 0x70, 0x21, 0xA0, 0x22, 0x00, 0x02, 0x60,
+ 0x12, 0x80, 0x32, 0xB0, 0x01, 0xF0, 0x0A, 0x22, 0x60, 0x12, 0x60, 0x32, 0xD0, 0x01, 0xF0, 0x0A,
+ 0x52, 0x30, 0x12, 0x30, 0x72, 0xF0, 0x17, 0xF2, 0x05, 0x10, 0x12, 0xF0, 0x16, 0x22, 0x40, 0xA2,
+ 0x50, 0x12, 0xF0, 0x0F, 0x41, 0xF0, 0x0C, 0x21, 0xF0, 0x0C, 0x01, 0x20, 0x01, 0xD0, 0x21, 0xA0,
+ 0x21, 0xF0, 0x0F, 0x01, 0xD0, 0x01, 0xD0, 0x01, 0xF0, 0x11, 0x01, 0xC0, 0x01, 0xE0, 0x01, 0xF0,
+ 0x10, 0x01, 0xC0, 0x41, 0xB0, 0x31, 0xF0, 0x0D, 0x01, 0xC0, 0x11, 0x10, 0x11, 0xC0, 0x11, 0xF0,
+ 0x0D, 0x01, 0xC0, 0x11, 0x10, 0x11, 0xC0, 0x11, 0xF0, 0x0D, 0x01, 0xC0, 0x11, 0x10, 0x11, 0x90,
+ 0x11, 0x00, 0x01, 0xF0, 0x1E, 0x21, 0xF0, 0x4F,
+};
+
+const RLEBitmap clockBitmap = {64, 64, clockPalette, clockRuns, 616};
@@ -0,0 +1,121 @@
+// clockHands.h
+// Generated by Tools/handtable.py, do not edit by hand
+// (x,y) offsets from the clock center to the tip of each hand
+
+#ifndef CLOCKHANDS_H
+#define CLOCKHANDS_H
+
+#include <stdint.h>
+
+#define HOUR_HAND_SIZE      17
+#define MINUTE_HAND_SIZE    25
+#define MINUTE_POSITIONS    60
+#define HOUR_POSITIONS      720
+
+// index is the minute, 0 to 59
+static const int8_t MinuteHand[60][2] = {
+ {  0,-25}, {  3,-25}, {  5,-24}, {  8,-24}, { 10,-23}, { 12,-22}, { 15,-20}, { 17,-19},
+ { 19,-17}, { 20,-15}, { 22,-13}, { 23,-10}, { 24, -8}, { 24, -5}, { 25, -3}, { 25,  0},
+ { 25,  3}, { 24,  5}, { 24,  8}, { 23, 10}, { 22, 12}, { 20, 15}, { 19, 17}, { 17, 19},
+ { 15, 20}, { 12, 22}, { 10, 23}, {  8, 24}, {  5, 24}, {  3, 25}, {  0, 25}, { -3, 25},
+ { -5, 24}, { -8, 24}, {-10, 23}, {-12, 22}, {-15, 20}, {-17, 19}, {-19, 17}, {-20, 15},
+ {-22, 13}, {-23, 10}, {-24,  8}, {-24,  5}, {-25,  3}, {-25,  0}, {-25, -3}, {-24, -5},
+ {-24, -8}, {-23,-10}, {-22,-13}, {-20,-15}, {-19,-17}, {-17,-19}, {-15,-20}, {-12,-22},
+ {-10,-23}, { -8,-24}, { -5,-24}, { -3,-25},
+};
+
+// index is (hour%12)*60 + minute, 0 to 719
+static const int8_t HourHand[720][2] = {
+ {  0,-17}, {  0,-17}, {  0,-17}, {  0,-17}, {  1,-17}, {  1,-17}, {  1,-17}, {  1,-17},
+ {  1,-17}, {  1,-17}, {  1,-17}, {  2,-17}, {  2,-17}, {  2,-17}, {  2,-17}, {  2,-17},
+ {  2,-17}, {  3,-17}, {  3,-17}, {  3,-17}, {  3,-17}, {  3,-17}, {  3,-17}, {  3,-17},
+ {  4,-17}, {  4,-17}, {  4,-17}, {  4,-17}, {  4,-16}, {  4,-16}, {  4,-16}, {  5,-16},
+ {  5,-16}, {  5,-16}, {  5,-16}, {  5,-16}, {  5,-16}, {  5,-16}, {  6,-16}, {  6,-16},
+ {  6,-16}, {  6,-16}, {  6,-16}, {  6,-16}, {  6,-16}, {  7,-16}, {  7,-16}, {  7,-16},
+ {  7,-16}, {  7,-15}, {  7,-15}, {  7,-15}, {  7,-15}, {  8,-15}, {  8,-15}, {  8,-15},
+ {  8,-15}, {  8,-15}, {  8,-15}, {  8,-15}, {  8,-15}, {  9,-15}, {  9,-15}, {  9,-14},
+ {  9,-14}, {  9,-14}, {  9,-14}, {  9,-14}, { 10,-14}, { 10,-14}, { 10,-14}, { 10,-14},
+ { 10,-14}, { 10,-14}, { 10,-14}, { 10,-13}, { 10,-13}, { 11,-13}, { 11,-13}, { 11,-13},
+ { 11,-13}, { 11,-13}, { 11,-13}, { 11,-13}, { 11,-13}, { 11,-13}, { 12,-12}, { 12,-12},
+ { 12,-12}, { 12,-12}, { 12,-12}, { 12,-12}, { 12,-12}, { 12,-12}, { 12,-12}, { 13,-11},
+ { 13,-11}, { 13,-11}, { 13,-11}, { 13,-11}, { 13,-11}, { 13,-11}, { 13,-11}, { 13,-11},
+ { 13,-10}, { 13,-10}, { 14,-10}, { 14,-10}, { 14,-10}, { 14,-10}, { 14,-10}, { 14,-10},
+ { 14,-10}, { 14, -9}, { 14, -9}, { 14, -9}, { 14, -9}, { 14, -9}, { 15, -9}, { 15, -9},
+ { 15, -9}, { 15, -8}, { 15, -8}, { 15, -8}, { 15, -8}, { 15, -8}, { 15, -8}, { 15, -8},
+ { 15, -7}, { 15, -7}, { 15, -7}, { 15, -7}, { 16, -7}, { 16, -7}, { 16, -7}, { 16, -7},
+ { 16, -6}, { 16, -6}, { 16, -6}, { 16, -6}, { 16, -6}, { 16, -6}, { 16, -6}, { 16, -5},
+ { 16, -5}, { 16, -5}, { 16, -5}, { 16, -5}, { 16, -5}, { 16, -5}, { 16, -4}, { 16, -4},
+ { 16, -4}, { 17, -4}, { 17, -4}, { 17, -4}, { 17, -4}, { 17, -3}, { 17, -3}, { 17, -3},
+ { 17, -3}, { 17, -3}, { 17, -3}, { 17, -3}, { 17, -2}, { 17, -2}, { 17, -2}, { 17, -2},
+ { 17, -2}, { 17, -2}, { 17, -1}, { 17, -1}, { 17, -1}, { 17, -1}, { 17, -1}, { 17, -1},
+ { 17, -1}, { 17,  0}, { 17,  0}, { 17,  0}, { 17,  0}, { 17,  0}, { 17,  0}, { 17,  0},
+ { 17,  1}, { 17,  1}, { 17,  1}, { 17,  1}, { 17,  1}, { 17,  1}, { 17,  1}, { 17,  2},
+ { 17,  2}, { 17,  2}, { 17,  2}, { 17,  2}, { 17,  2}, { 17,  3}, { 17,  3}, { 17,  3},
+ { 17,  3}, { 17,  3}, { 17,  3}, { 17,  3}, { 17,  4}, { 17,  4}, { 17,  4}, { 17,  4},
+ { 16,  4}, { 16,  4}, { 16,  4}, { 16,  5}, { 16,  5}, { 16,  5}, { 16,  5}, { 16,  5},
+ { 16,  5}, { 16,  5}, { 16,  6}, { 16,  6}, { 16,  6}, { 16,  6}, { 16,  6}, { 16,  6},
+ { 16,  6}, { 16,  7}, { 16,  7}, { 16,  7}, { 16,  7}, { 15,  7}, { 15,  7}, { 15,  7},
+ { 15,  7}, { 15,  8}, { 15,  8}, { 15,  8}, { 15,  8}, { 15,  8}, { 15,  8}, { 15,  8},
+ { 15,  8}, { 15,  9}, { 15,  9}, { 14,  9}, { 14,  9}, { 14,  9}, { 14,  9}, { 14,  9},
+ { 14, 10}, { 14, 10}, { 14, 10}, { 14, 10}, { 14, 10}, { 14, 10}, { 14, 10}, { 13, 10},
+ { 13, 10}, { 13, 11}, { 13, 11}, { 13, 11}, { 13, 11}, { 13, 11}, { 13, 11}, { 13, 11},
+ { 13, 11}, { 13, 11}, { 12, 12}, { 12, 12}, { 12, 12}, { 12, 12}, { 12, 12}, { 12, 12},
+ { 12, 12}, { 12, 12}, { 12, 12}, { 11, 13}, { 11, 13}, { 11, 13}, { 11, 13}, { 11, 13},
+ { 11, 13}, { 11, 13}, { 11, 13}, { 11, 13}, { 10, 13}, { 10, 13}, { 10, 14}, { 10, 14},
+ { 10, 14}, { 10, 14}, { 10, 14}, { 10, 14}, { 10, 14}, {  9, 14}, {  9, 14}, {  9, 14},
+ {  9, 14}, {  9, 14}, {  9, 15}, {  9, 15}, {  8, 15}, {  8, 15}, {  8, 15}, {  8, 15},
+ {  8, 15}, {  8, 15}, {  8, 15}, {  8, 15}, {  7, 15}, {  7, 15}, {  7, 15}, {  7, 15},
+ {  7, 16}, {  7, 16}, {  7, 16}, {  7, 16}, {  6, 16}, {  6, 16}, {  6, 16}, {  6, 16},
+ {  6, 16}, {  6, 16}, {  6, 16}, {  5, 16}, {  5, 16}, {  5, 16}, {  5, 16}, {  5, 16},
+ {  5, 16}, {  5, 16}, {  4, 16}, {  4, 16}, {  4, 16}, {  4, 17}, {  4, 17}, {  4, 17},
+ {  4, 17}, {  3, 17}, {  3, 17}, {  3, 17}, {  3, 17}, {  3, 17}, {  3, 17}, {  3, 17},
+ {  2, 17}, {  2, 17}, {  2, 17}, {  2, 17}, {  2, 17}, {  2, 17}, {  1, 17}, {  1, 17},
+ {  1, 17}, {  1, 17}, {  1, 17}, {  1, 17}, {  1, 17}, {  0, 17}, {  0, 17}, {  0, 17},
+ {  0, 17}, {  0, 17}, {  0, 17}, {  0, 17}, { -1, 17}, { -1, 17}, { -1, 17}, { -1, 17},
+ { -1, 17}, { -1, 17}, { -1, 17}, { -2, 17}, { -2, 17}, { -2, 17}, { -2, 17}, { -2, 17},
+ { -2, 17}, { -3, 17}, { -3, 17}, { -3, 17}, { -3, 17}, { -3, 17}, { -3, 17}, { -3, 17},
+ { -4, 17}, { -4, 17}, { -4, 17}, { -4, 17}, { -4, 16}, { -4, 16}, { -4, 16}, { -5, 16},
+ { -5, 16}, { -5, 16}, { -5, 16}, { -5, 16}, { -5, 16}, { -5, 16}, { -6, 16}, { -6, 16},
+ { -6, 16}, { -6, 16}, { -6, 16}, { -6, 16}, { -6, 16}, { -7, 16}, { -7, 16}, { -7, 16},
+ { -7, 16}, { -7, 15}, { -7, 15}, { -7, 15}, { -7, 15}, { -8, 15}, { -8, 15}, { -8, 15},
+ { -8, 15}, { -8, 15}, { -8, 15}, { -8, 15}, { -9, 15}, { -9, 15}, { -9, 15}, { -9, 14},
+ { -9, 14}, { -9, 14}, { -9, 14}, { -9, 14}, {-10, 14}, {-10, 14}, {-10, 14}, {-10, 14},
+ {-10, 14}, {-10, 14}, {-10, 14}, {-10, 13}, {-10, 13}, {-11, 13}, {-11, 13}, {-11, 13},
+ {-11, 13}, {-11, 13}, {-11, 13}, {-11, 13}, {-11, 13}, {-11, 13}, {-12, 12}, {-12, 12},
+ {-12, 12}, {-12, 12}, {-12, 12}, {-12, 12}, {-12, 12}, {-12, 12}, {-12, 12}, {-13, 11},
+ {-13, 11}, {-13, 11}, {-13, 11}, {-13, 11}, {-13, 11}, {-13, 11}, {-13, 11}, {-13, 11},
+ {-13, 10}, {-13, 10}, {-14, 10}, {-14, 10}, {-14, 10}, {-14, 10}, {-14, 10}, {-14, 10},
+ {-14, 10}, {-14,  9}, {-14,  9}, {-14,  9}, {-14,  9}, {-14,  9}, {-15,  9}, {-15,  9},
+ {-15,  9}, {-15,  8}, {-15,  8}, {-15,  8}, {-15,  8}, {-15,  8}, {-15,  8}, {-15,  8},
+ {-15,  7}, {-15,  7}, {-15,  7}, {-15,  7}, {-16,  7}, {-16,  7}, {-16,  7}, {-16,  7},
+ {-16,  6}, {-16,  6}, {-16,  6}, {-16,  6}, {-16,  6}, {-16,  6}, {-16,  6}, {-16,  5},
+ {-16,  5}, {-16,  5}, {-16,  5}, {-16,  5}, {-16,  5}, {-16,  5}, {-16,  4}, {-16,  4},
+ {-16,  4}, {-17,  4}, {-17,  4}, {-17,  4}, {-17,  4}, {-17,  3}, {-17,  3}, {-17,  3},
+ {-17,  3}, {-17,  3}, {-17,  3}, {-17,  3}, {-17,  2}, {-17,  2}, {-17,  2}, {-17,  2},
+ {-17,  2}, {-17,  2}, {-17,  1}, {-17,  1}, {-17,  1}, {-17,  1}, {-17,  1}, {-17,  1},
+ {-17,  1}, {-17,  0}, {-17,  0}, {-17,  0}, {-17,  0}, {-17,  0}, {-17,  0}, {-17,  0},
+ {-17, -1}, {-17, -1}, {-17, -1}, {-17, -1}, {-17, -1}, {-17, -1}, {-17, -1}, {-17, -2},
+ {-17, -2}, {-17, -2}, {-17, -2}, {-17, -2}, {-17, -2}, {-17, -3}, {-17, -3}, {-17, -3},
+ {-17, -3}, {-17, -3}, {-17, -3}, {-17, -3}, {-17, -4}, {-17, -4}, {-17, -4}, {-17, -4},
+ {-16, -4}, {-16, -4}, {-16, -4}, {-16, -5}, {-16, -5}, {-16, -5}, {-16, -5}, {-16, -5},
+ {-16, -5}, {-16, -5}, {-16, -6}, {-16, -6}, {-16, -6}, {-16, -6}, {-16, -6}, {-16, -6},
+ {-16, -6}, {-16, -7}, {-16, -7}, {-16, -7}, {-16, -7}, {-15, -7}, {-15, -7}, {-15, -7},
+ {-15, -7}, {-15, -8}, {-15, -8}, {-15, -8}, {-15, -8}, {-15, -8}, {-15, -8}, {-15, -8},
+ {-15, -9}, {-15, -9}, {-15, -9}, {-14, -9}, {-14, -9}, {-14, -9}, {-14, -9}, {-14, -9},
+ {-14,-10}, {-14,-10}, {-14,-10}, {-14,-10}, {-14,-10}, {-14,-10}, {-14,-10}, {-13,-10},
+ {-13,-10}, {-13,-11}, {-13,-11}, {-13,-11}, {-13,-11}, {-13,-11}, {-13,-11}, {-13,-11},
+ {-13,-11}, {-13,-11}, {-12,-12}, {-12,-12}, {-12,-12}, {-12,-12}, {-12,-12}, {-12,-12},
+ {-12,-12}, {-12,-12}, {-12,-12}, {-11,-13}, {-11,-13}, {-11,-13}, {-11,-13}, {-11,-13},
+ {-11,-13}, {-11,-13}, {-11,-13}, {-11,-13}, {-10,-13}, {-10,-13}, {-10,-14}, {-10,-14},
+ {-10,-14}, {-10,-14}, {-10,-14}, {-10,-14}, {-10,-14}, { -9,-14}, { -9,-14}, { -9,-14},
+ { -9,-14}, { -9,-14}, { -9,-15}, { -9,-15}, { -9,-15}, { -8,-15}, { -8,-15}, { -8,-15},
+ { -8,-15}, { -8,-15}, { -8,-15}, { -8,-15}, { -7,-15}, { -7,-15}, { -7,-15}, { -7,-15},
+ { -7,-16}, { -7,-16}, { -7,-16}, { -7,-16}, { -6,-16}, { -6,-16}, { -6,-16}, { -6,-16},
+ { -6,-16}, { -6,-16}, { -6,-16}, { -5,-16}, { -5,-16}, { -5,-16}, { -5,-16}, { -5,-16},
+ { -5,-16}, { -5,-16}, { -4,-16}, { -4,-16}, { -4,-16}, { -4,-17}, { -4,-17}, { -4,-17},
+ { -4,-17}, { -3,-17}, { -3,-17}, { -3,-17}, { -3,-17}, { -3,-17}, { -3,-17}, { -3,-17},
+ { -2,-17}, { -2,-17}, { -2,-17}, { -2,-17}, { -2,-17}, { -2,-17}, { -1,-17}, { -1,-17},
+ { -1,-17}, { -1,-17}, { -1,-17}, { -1,-17}, { -1,-17}, {  0,-17}, {  0,-17}, {  0,-17},
+};
+
+#endif
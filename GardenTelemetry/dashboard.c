@@ -0,0 +1,171 @@
+// dashboard.c
+// Runs on TM4C123
+// Bench dashboard built on the ui layer. Values are copied into the
+// widget sources once per frame and Ui_Refresh repaints the ones that
+// changed. The sparklines change only when a sample arrives, and each
+// is sent as one 128x20 window.
+// Frames are requested by Dashboard_Tick from the sampling interrupt,
+// which caps the frame rate at one per sample period.
+
+#include <stdint.h>
+#include "dashboard.h"
+#include "ui.h"
+#include "ST7735.h"
+#include "timeseries.h"
+#include "esp8266.h"
+#include "qformat.h"
+#include "events.h"
+#include "../inc/tm4c123gh6pm.h"
+
+#define DASHBOARD_TITLE "Dashboard"
+
+#define HEATER_BIT 0x04          // PB2, see initActuators
+#define WATER_BIT  0x08          // PB3
+#define LIGHT_BIT  0x10          // PB4
+
+#define SPARK_WIDTH  128         // one column per raw sample
+#define SPARK_HEIGHT 20          // fits in one word for ST7735_DrawColumnBits
+#define SENSOR_ROWS  3           // text row plus two rows of sparkline
+
+#define ACTUATOR_ROW 10
+#define LINK_ROW     13
+#define QUEUE_ROW    14
+#define LOAD_ROW     15
+#define VALUE_COL    10
+
+const uint16_t SensorColor[TS_NUM_SENSORS] = {ST7735_GREEN, ST7735_CYAN, ST7735_MAGENTA};
+char *const SensorName[TS_NUM_SENSORS] = {"Sensor 1", "Sensor 2", "Sensor 3"};
+
+int32_t sensorValue[TS_NUM_SENSORS];
+int32_t sparkFrame = 0;          // samples seen when the values were copied, repaints the sparklines
+char heaterText[4];
+char waterText[4];
+char lightText[4];
+char linkText[8];
+int32_t uplinkBytes = 0;
+int32_t cpuLoad = 0;
+
+uint32_t volatile framesDue = 0;
+uint32_t volatile samplesTaken = 0;
+uint32_t volatile lastMessageCount = 0;
+uint32_t volatile msSinceMessage = 0;
+uint32_t volatile heardFromApp = 0;
+
+TimeSeries_Bucket static SparkPoints[SPARK_WIDTH];
+uint32_t static SparkBits[SPARK_WIDTH];		//one column of the sparkline per word
+
+void static drawSparkline(uint32_t sensor)
+{
+	int y0 = (2 + SENSOR_ROWS * sensor) * 10;
+	uint32_t num = TimeSeries_Read(sensor, TS_RAW, SPARK_WIDTH, SparkPoints);
+	uint32_t low = 0xFFFF, high = 0;
+	for(uint32_t i = 0; i < num; i++)
+	{
+		if(SparkPoints[i].mean < low) {low = SparkPoints[i].mean;}
+		if(SparkPoints[i].mean > high) {high = SparkPoints[i].mean;}
+	}
+	int x = 0;
+	for(; x < SPARK_WIDTH - (int)num; x++)		//newest sample is always in the last column
+	{
+		SparkBits[x] = 0;
+	}
+	int previous = -1;
+	for(uint32_t i = 0; i < num; i++, x++)
+	{
+		int row = SPARK_HEIGHT / 2;
+		if(high > low) {row = (SPARK_HEIGHT - 1) - (SparkPoints[i].mean - low) * (SPARK_HEIGHT - 1) / (high - low);}
+		int top = row, bottom = row;
+		if(previous >= 0)		//join to the last point so steep changes stay visible
+		{
+			if(previous < top) {top = previous;}
+			if(previous > bottom) {bottom = previous;}
+		}
+		SparkBits[x] = (2UL << bottom) - (1UL << top);
+		previous = row;
+	}
+	ST7735_DrawBitColumns(0, y0, SPARK_WIDTH, SPARK_HEIGHT, SparkBits, SensorColor[sensor], ST7735_BLACK);
+}
+
+void static drawSparkline0(void) {drawSparkline(0);}
+void static drawSparkline1(void) {drawSparkline(1);}
+void static drawSparkline2(void) {drawSparkline(2);}
+void (*const DrawSparkline[TS_NUM_SENSORS])(void) = {&drawSparkline0, &drawSparkline1, &drawSparkline2};
+
+void static setText(char *text, const char *value)
+{
+	while(*value) {*text++ = *value++;}
+	*text = 0;
+}
+
+void static setState(char *text, uint32_t bit)
+{
+	setText(text, (GPIO_PORTB_DATA_R & bit) ? "ON" : "OFF");
+}
+
+void static updateValues(void)
+{
+	for(uint32_t i = 0; i < TS_NUM_SENSORS; i++) {sensorValue[i] = TimeSeries_Latest(i);}
+	setState(heaterText, HEATER_BIT);
+	setState(waterText, WATER_BIT);
+	setState(lightText, LIGHT_BIT);
+	if(heardFromApp)
+	{
+		uint32_t length = Fmt_UDec(linkText, msSinceMessage / 1000);
+		linkText[length++] = 's';
+		linkText[length] = 0;
+	}
+	else {setText(linkText, "none");}
+	uplinkBytes = ESP8266_OutputQueueSize();
+	cpuLoad = Event_CpuLoad();
+	sparkFrame = samplesTaken;
+}
+
+void Dashboard_Show(void)
+{
+	updateValues();
+	framesDue = 0;
+	Ui_Begin();
+	Ui_Label(0, 0, 16, DASHBOARD_TITLE, ST7735_YELLOW);
+	for(uint32_t i = 0; i < TS_NUM_SENSORS; i++)
+	{
+		Ui_Label(0, 1 + SENSOR_ROWS * i, 9, SensorName[i], SensorColor[i]);
+		Ui_Number(VALUE_COL, 1 + SENSOR_ROWS * i, 5, &sensorValue[i], 0, ST7735_WHITE);
+		Ui_Region(0, (2 + SENSOR_ROWS * i) * 10, SPARK_WIDTH, SPARK_HEIGHT, &sparkFrame, DrawSparkline[i]);
+	}
+	Ui_Label(0, ACTUATOR_ROW, 9, "Heater", ST7735_YELLOW);
+	Ui_Label(VALUE_COL, ACTUATOR_ROW, 3, heaterText, ST7735_WHITE);
+	Ui_Label(0, ACTUATOR_ROW + 1, 9, "Water", ST7735_YELLOW);
+	Ui_Label(VALUE_COL, ACTUATOR_ROW + 1, 3, waterText, ST7735_WHITE);
+	Ui_Label(0, ACTUATOR_ROW + 2, 9, "Light", ST7735_YELLOW);
+	Ui_Label(VALUE_COL, ACTUATOR_ROW + 2, 3, lightText, ST7735_WHITE);
+	Ui_Label(0, LINK_ROW, 9, "Last rx", ST7735_YELLOW);
+	Ui_Label(VALUE_COL, LINK_ROW, 7, linkText, ST7735_WHITE);
+	Ui_Label(0, QUEUE_ROW, 9, "Uplink q", ST7735_YELLOW);
+	Ui_Number(VALUE_COL, QUEUE_ROW, 5, &uplinkBytes, 0, ST7735_WHITE);
+	Ui_Label(0, LOAD_ROW, 9, "CPU %", ST7735_YELLOW);
+	Ui_Number(VALUE_COL, LOAD_ROW, 3, &cpuLoad, 0, ST7735_WHITE);
+	Ui_End();
+}
+
+void Dashboard_Tick(uint32_t periodMs)
+{
+	uint32_t count = ESP8266_MessageCount();
+	if(count != lastMessageCount)
+	{
+		lastMessageCount = count;
+		msSinceMessage = 0;
+		heardFromApp = 1;
+	}
+	else if(msSinceMessage < 99999000) {msSinceMessage += periodMs;}
+	samplesTaken++;
+	framesDue = 1;
+}
+
+int Dashboard_Update(void)
+{
+	if(framesDue == 0) {return 0;}
+	framesDue = 0;
+	updateValues();
+	Ui_Refresh();
+	return 1;
+}
@@ -0,0 +1,34 @@
+// dashboard.h
+// Runs on TM4C123
+// Bench dashboard: every sensor with a sparkline of its recent history,
+// the heater, water and light outputs, the age of the last message from
+// the Blynk app, the number of bytes waiting to go to the ESP8266 and
+// the CPU load.
+// The screen is built once with the ui layer and then refreshed at most
+// once per sample period, repainting only the widgets that changed.
+
+#ifndef DASHBOARD_H
+#define DASHBOARD_H
+
+#include <stdint.h>
+
+//------------Dashboard_Show------------
+// Builds the dashboard screen, repainting what differs from the last screen
+// Inputs:  none
+// Outputs: none
+void Dashboard_Show(void);
+
+//------------Dashboard_Tick------------
+// Marks a new frame as due, called from the sampling interrupt once the
+// period's samples are stored, so the sparklines know a sample arrived
+// Inputs:  periodMs   time since the last call, for the age of the last app message
+// Outputs: none
+void Dashboard_Tick(uint32_t periodMs);
+
+//------------Dashboard_Update------------
+// Repaints the dashboard if a frame is due, called from the main loop
+// Inputs:  none
+// Outputs: 1 if a frame was drawn, 0 if none was due
+int Dashboard_Update(void);
+
+#endif
@@ -27,6 +27,9 @@
 #include "UART.h"
 #include "ST7735.h"
 #include "esp8266.h"
+#include "frame.h"
+#include "qformat.h"
+#include "events.h"
 // the following two lines connect you to the internet
 //char    ssid[32]        = "EE-IOT-Platform-03";
 //char    pass[32]        = "dUQQE?&W44x7";
@@ -56,6 +59,10 @@ char    auth[64]        = "ee284da122f14ee49c8a323c1d87f7cc";
 #define UART_RIS_RXRIS          0x00000010  // UART Receive Raw Interrupt
                                             // Status
 #define UART_ICR_RTIC           0x00000040  // Receive Time-Out Interrupt Clear
+#define UART_DR_OE              0x00000800  // UART Overrun Error
+#define UART_DR_BE              0x00000400  // UART Break Error
+#define UART_DR_PE              0x00000200  // UART Parity Error
+#define UART_DR_FE              0x00000100  // UART Framing Error
 #define UART_ICR_TXIC           0x00000020  // Transmit Interrupt Clear
 #define UART_ICR_RXIC           0x00000010  // Receive Interrupt Clear
 
@@ -69,107 +76,241 @@ void WaitForInterrupt(void);  // low power mode
 #define FIFOSUCCESS 1         // return value on success
 #define FIFOFAIL    0         // return value on failure
                               // create index implementation FIFO (see FIFO.h)
-// Two-index implementation of the receive FIFO
-// can hold 0 to RX5FIFOSIZE messages
-#define RX5FIFOSIZE 8    // must be a power of 2
-#define MESSAGESIZE 64
-uint32_t volatile Rx5PutI; // put next message
-uint32_t volatile Rx5PutJ; // put next character 0 to MESSAGESIZE-1
-uint32_t volatile Rx5GetI; // get next message
-char Rx5Fifo[RX5FIFOSIZE][MESSAGESIZE]; // each message can have up to MESSAGESIZE-1 characters
+// Receive FIFO of whole messages kept end to end in a ring of bytes, so a
+// message takes only the room it needs. Every message is stored ending in
+// ",\n", which also marks where the next one starts.
+// can hold 0 to RX5ARENASIZE bytes of messages
+#define RX5ARENASIZE 512 // must be a power of 2
+#define MESSAGESIZE ESP8266_MESSAGESIZE
+#if RX5ARENASIZE < MESSAGESIZE
+#error "the arena must fit the longest message, or one could never complete"
+#endif
+uint32_t volatile Rx5PutI; // first byte of the message being received
+uint32_t volatile Rx5PutJ; // characters of that message so far, 0 to MESSAGESIZE-4
+uint32_t volatile Rx5GetI; // first byte of the oldest message
+uint32_t volatile Rx5PutCount; // messages completed
+uint32_t volatile Rx5GetCount; // messages removed
+uint32_t volatile Rx5Discard; // 1 while dropping the rest of a message that did not fit
+char Rx5Arena[RX5ARENASIZE];
 char RxMessage[MESSAGESIZE];
-// initialize index FIFO
+uint32_t volatile RxMessageCount = 0; // messages taken by ESP8266_GetMessage
+uint32_t volatile Rx5Overruns = 0;    // characters that arrived while the UART5 hardware FIFO was full
+uint32_t volatile Rx5LineErrors = 0;  // characters received with a framing, parity or break error
+uint32_t volatile Rx5Dropped = 0;     // messages dropped because the arena was full
+uint32_t volatile Rx5Truncated = 0;   // messages cut short at MESSAGESIZE-4 characters
+uint32_t volatile Rx5HighWater = 0;   // most messages waiting
+uint32_t volatile Rx5HighWaterBytes = 0; // most bytes of the arena in use
+uint32_t volatile Rx5BadFrames = 0;   // binary frames rejected by their CRC or framing
+void static copyHardwareToSoftware5(void);
+// free bytes in the arena, the message being received counts as used
+uint32_t static rx5Room(void){
+  return RX5ARENASIZE - (Rx5PutI - Rx5GetI) - Rx5PutJ;
+}
+#ifdef ESP8266_FLOWCONTROL
+// RTS is a GPIO since UART5 has no flow control pins
+#define RTS5      (*((volatile uint32_t *)0x40007010))    // PD2, RTS to ESP8266
+#define RTS5_STOP 0x04
+// ask the ESP8266 to stop while a quarter of the arena is still free for what it has in flight
+void static rts5Update(void){ uint32_t room = rx5Room();
+  if(room < RX5ARENASIZE/4){
+    RTS5 = RTS5_STOP;
+  }else if(room >= RX5ARENASIZE/2){
+    RTS5 = 0;
+  }
+}
+void static rts5Init(void){
+  SYSCTL_RCGCGPIO_R |= 0x08; // activate port D
+  while((SYSCTL_PRGPIO_R&0x08)==0){};
+  GPIO_PORTD_DIR_R |= 0x04;       // output digital I/O on PD2
+  GPIO_PORTD_AFSEL_R &= ~0x04;    // disable alt funct on PD2
+  GPIO_PORTD_DEN_R |= 0x04;       // enable digital I/O on PD2
+  GPIO_PORTD_PCTL_R = (GPIO_PORTD_PCTL_R&0xFFFFF0FF);
+  GPIO_PORTD_AMSEL_R &= ~0x04;    // disable analog functionality on PD2
+  RTS5 = 0;                       // ready to receive
+}
+#define RTS5_UPDATE() rts5Update()
+#else
+#define RTS5_UPDATE()
+#endif
+// initialize arena FIFO
 void Rx5Fifo_Init(void){ long sr;
   sr = StartCritical(); // make atomic
   Rx5PutI = Rx5GetI = Rx5PutJ = 0;  // Empty
+  Rx5PutCount = Rx5GetCount = 0;
+  Rx5Discard = 0;
   EndCritical(sr);
 }
-// add element to end of index FIFO
+// add element to end of arena FIFO
+// each character is only taken if the ",\n" after it will still fit
+// a message that is too long is cut short and the rest dropped up to its '\n',
+// a message that finds the arena full is dropped whole
 // return TXFIFOSUCCESS if successful
-int Rx5Fifo_Put(char data){
-  if((Rx5PutI-Rx5GetI) & ~(RX5FIFOSIZE-1)){
-    return(FIFOFAIL); // Failed, fifo full
+int Rx5Fifo_Put(char data){ uint32_t used;
+  if(Rx5Discard){
+    if(data == '\n'){
+      Rx5Discard = 0; // resynchronized
+      Rx5PutJ = 0;
+    }
+    return(FIFOSUCCESS);
   }
-  Rx5Fifo[Rx5PutI&(RX5FIFOSIZE-1)][Rx5PutJ] = data; // put
   if(data != '\n'){
-    if(Rx5PutJ == (MESSAGESIZE-3)){
-      // you should never get here!
-      Rx5Fifo[Rx5PutI&(RX5FIFOSIZE-1)][MESSAGESIZE-2] = ',';
-      Rx5Fifo[Rx5PutI&(RX5FIFOSIZE-1)][MESSAGESIZE-1] = '\n'; // message overflow, force a '\n'
-      Rx5PutI++;   // end of message
-      Rx5PutJ = 0; // get ready for new message
-      return(FIFOSUCCESS); // bad situation, message buffer overflow
+    if(Rx5PutJ >= (MESSAGESIZE-4)){
+      Rx5Discard = 1; // message overflow, keep what fit and force a '\n'
+      Rx5Truncated++;
+    }else if(rx5Room() < 3){
+      Rx5Discard = 1; // drop the part already stored
+      Rx5PutJ = 0;
+      Rx5Dropped++;
+      return(FIFOFAIL); // Failed, fifo full
+    }else{
+      Rx5Arena[(Rx5PutI+Rx5PutJ)&(RX5ARENASIZE-1)] = data; // put
+      Rx5PutJ++;  // Success, update
+      return(FIFOSUCCESS);
     }
-    Rx5PutJ++;  // Success, update
-    return(FIFOSUCCESS);
   }
-  Rx5Fifo[Rx5PutI&(RX5FIFOSIZE-1)][Rx5PutJ] = ',';
-  Rx5Fifo[Rx5PutI&(RX5FIFOSIZE-1)][Rx5PutJ+1] = '\n';
-  Rx5PutI++;   // end of message
+  if(rx5Room() < 2){   // only an empty message gets here without room checked
+    Rx5Dropped++;
+    return(FIFOFAIL);
+  }
+  Rx5Arena[(Rx5PutI+Rx5PutJ)&(RX5ARENASIZE-1)] = ',';
+  Rx5Arena[(Rx5PutI+Rx5PutJ+1)&(RX5ARENASIZE-1)] = '\n';
+  Rx5PutI += Rx5PutJ+2;   // end of message
   Rx5PutJ = 0; // get ready for new message
+  Rx5PutCount++;
+  if((Rx5PutCount-Rx5GetCount) > Rx5HighWater){
+    Rx5HighWater = Rx5PutCount-Rx5GetCount;
+  }
+  used = Rx5PutI-Rx5GetI;
+  if(used > Rx5HighWaterBytes){
+    Rx5HighWaterBytes = used;
+  }
+  RTS5_UPDATE();
   return(FIFOSUCCESS);
 }
-// remove a message from front of index FIFO
-// datapt points to an empty data buffer of MESSAGESIZE character
-// if successful a message is copied from the FIFO into data buffer
+// remove a message from front of arena FIFO
+// datapt points to an empty data buffer of ESP8266_MESSAGESIZE characters
+// if successful a message is copied from the FIFO into data buffer,
+// ending in '\n' followed by a null
 // return FIFOSUCCESS if successful
 // return FIFOFAIL if the FIFO is empty (no messages)
 int ESP8266_GetMessage(char *datapt){char data; int j;
-  if(Rx5PutI == Rx5GetI ){
-    return(FIFOFAIL); // Empty if PutI=GetI
+  if(Rx5PutCount == Rx5GetCount){
+    return(FIFOFAIL); // Empty if PutCount=GetCount
   }
   j = 0;
   do{
-    data = Rx5Fifo[Rx5GetI&(RX5FIFOSIZE-1)][j];
+    data = Rx5Arena[(Rx5GetI+j)&(RX5ARENASIZE-1)];
     datapt[j] = data;
     j++;
-  }while((j<MESSAGESIZE)&&(data != '\n'));
-  Rx5GetI++;  // Success, update
+  }while((j<MESSAGESIZE-1)&&(data != '\n'));
+  datapt[j] = 0;
+  Rx5GetI += j;  // Success, update
+  Rx5GetCount++;
+  RxMessageCount++;
+  RTS5_UPDATE();
+  // characters held back in the hardware FIFO while the arena was full
+  UART5_IM_R &= ~(UART_IM_RXIM|UART_IM_RTIM);
+  copyHardwareToSoftware5();
+  UART5_IM_R |= (UART_IM_RXIM|UART_IM_RTIM);
   return(FIFOSUCCESS);
 }
-// number of messages in index FIFO
-// 0 to RX5FIFOSIZE-1
+uint32_t ESP8266_MessageCount(void){
+  return RxMessageCount;
+}
+void ESP8266_GetRxStats(ESP8266_RxStats *stats){ long sr;
+  sr = StartCritical(); // one consistent snapshot
+  stats->overruns = Rx5Overruns;
+  stats->lineErrors = Rx5LineErrors;
+  stats->dropped = Rx5Dropped;
+  stats->truncated = Rx5Truncated;
+  stats->highWater = Rx5HighWater;
+  stats->highWaterBytes = Rx5HighWaterBytes;
+  stats->badFrames = Rx5BadFrames;
+  stats->waiting = Rx5PutCount-Rx5GetCount;
+  EndCritical(sr);
+}
+// number of messages in arena FIFO
 uint32_t Rx5Fifo_Size(void){
- return ((uint32_t)(Rx5PutI-Rx5GetI));
+ return ((uint32_t)(Rx5PutCount-Rx5GetCount));
 }  
 
-// Two-index implementation of the transmit FIFO
-// can hold 0 to TX5FIFOSIZE elements
-#define TX5FIFOSIZE 256    // must be a power of 2
-uint32_t volatile Tx5PutI; // put next
-uint32_t volatile Tx5GetI; // get next
-char static Tx5Fifo[TX5FIFOSIZE];
+// Transmit queues, one ring of bytes per priority tier. Each message is
+// stored as its length, the low 16 bits of Event_Ticks when it was queued,
+// then its bytes. Messages go out whole: between two messages the oldest
+// one of the highest tier that has any is copied out of its queue and
+// sent, so an alert waits for at most the message already going out and
+// the hardware FIFO. Queuing never waits; when a tier is full its policy
+// decides which message is lost.
+#define TX5QUEUESIZE 256   // per tier, must be a power of 2
+#define TX5HEADER 3        // length and queue time
+#define TX5MAXMESSAGE (TX5QUEUESIZE-TX5HEADER)
+#define TX5CSVLINE 27      // longest "pin,value,0.0\n" ESP8266_SendPin makes
+#if TX5MAXMESSAGE > 255
+#error "the message length is stored in one byte"
+#endif
+uint32_t volatile Tx5PutI[ESP8266_TIERS]; // first byte of the next message
+uint32_t volatile Tx5GetI[ESP8266_TIERS]; // first byte of the oldest message
+char static Tx5Queue[ESP8266_TIERS][TX5QUEUESIZE];
+uint32_t Tx5Policy[ESP8266_TIERS] = {ESP8266_DROP_OLDEST, ESP8266_DROP_OLDEST, ESP8266_REJECT};
+char static Tx5Current[TX5MAXMESSAGE]; // message going out
+uint32_t Tx5Tier;          // its tier
+uint32_t Tx5CurrentI;      // next byte of it to send
+uint32_t Tx5Left;          // bytes of it still to send, 0 between messages
+char static Tx5Line[TX5MAXMESSAGE]; // line being built by ESP8266_OutChar
+uint32_t Tx5LineLength;
+uint32_t volatile Tx5Messages[ESP8266_TIERS];  // messages started
+uint32_t volatile Tx5Bytes[ESP8266_TIERS];     // message bytes sent
+uint32_t volatile Tx5HighWater[ESP8266_TIERS]; // most bytes queued
+uint32_t volatile Tx5WaitSum[ESP8266_TIERS];   // ticks messages waited, for the mean
+uint32_t volatile Tx5WaitMax[ESP8266_TIERS];   // longest wait in ticks
+uint32_t volatile Tx5Dropped[ESP8266_TIERS];   // messages lost to a full tier
+uint32_t volatile Tx5Rejected[ESP8266_TIERS];  // messages refused by a full ESP8266_REJECT tier
 
-// initialize index FIFO
-void Tx5Fifo_Init(void){ long sr;
+// empty every tier
+void Tx5Fifo_Init(void){ long sr; uint32_t tier;
   sr = StartCritical(); // make atomic
-  Tx5PutI = Tx5GetI = 0;  // Empty
+  for(tier = 0; tier < ESP8266_TIERS; tier++){
+    Tx5PutI[tier] = Tx5GetI[tier] = 0;  // Empty
+  }
+  Tx5Left = 0;
+  Tx5LineLength = 0;
   EndCritical(sr);
 }
-// add element to end of index FIFO
-// return TXFIFOSUCCESS if successful
-int Tx5Fifo_Put(char data){
-  if((Tx5PutI-Tx5GetI) & ~(TX5FIFOSIZE-1)){
-    return(FIFOFAIL); // Failed, fifo full
+// bytes queued in all tiers, headers included, and left of the message going out
+uint32_t static tx5Size(void){ uint32_t tier, size = Tx5Left;
+  for(tier = 0; tier < ESP8266_TIERS; tier++){
+    size += Tx5PutI[tier]-Tx5GetI[tier];
   }
-  Tx5Fifo[Tx5PutI&(TX5FIFOSIZE-1)] = data; // put
-  Tx5PutI++;  // Success, update
-  return(FIFOSUCCESS);
+  return size;
 }
-// remove element from front of index FIFO
-// return TXFIFOSUCCESS if successful
-int Tx5Fifo_Get(char *datapt){
-  if(Tx5PutI == Tx5GetI ){
-    return(FIFOFAIL); // Empty if TxPutI=TxGetI
+// start the oldest message of the highest tier that has one
+// return FIFOFAIL if every tier is empty
+int static tx5NextMessage(void){ uint32_t tier, getI, queued, wait, i;
+  for(tier = 0; tier < ESP8266_TIERS; tier++){
+    getI = Tx5GetI[tier];
+    if(Tx5PutI[tier] != getI){
+      Tx5Left = (uint8_t)Tx5Queue[tier][getI&(TX5QUEUESIZE-1)];
+      queued = (uint8_t)Tx5Queue[tier][(getI+1)&(TX5QUEUESIZE-1)] |
+               ((uint8_t)Tx5Queue[tier][(getI+2)&(TX5QUEUESIZE-1)]<<8);
+      wait = (uint16_t)(Event_Ticks()-queued);
+      for(i = 0; i < Tx5Left; i++){
+        Tx5Current[i] = Tx5Queue[tier][(getI+TX5HEADER+i)&(TX5QUEUESIZE-1)];
+      }
+      Tx5GetI[tier] = getI+TX5HEADER+Tx5Left;  // the room is free for the writers again
+      Tx5CurrentI = 0;
+      Tx5Tier = tier;
+      Tx5Messages[tier]++;
+      Tx5WaitSum[tier] += wait;
+      if(wait > Tx5WaitMax[tier]){
+        Tx5WaitMax[tier] = wait;
+      }
+      return(FIFOSUCCESS);
+    }
   }
-  *datapt = Tx5Fifo[Tx5GetI&(TX5FIFOSIZE-1)];
-  Tx5GetI++;  // Success, update
-  return(FIFOSUCCESS);
+  return(FIFOFAIL);
 }
-// number of elements in index FIFO
-// 0 to TX5FIFOSIZE-1
-unsigned long Tx5Fifo_Size(void){
- return ((unsigned long)(Tx5PutI-Tx5GetI));
+uint32_t ESP8266_OutputQueueSize(void){
+  return tx5Size();
 }
 
 // Initialize UART5, interrupt driven
@@ -211,23 +352,263 @@ void UART5_Init(uint32_t priority){
   NVIC_EN1_R = 0x01<<(61-32);           // enable interrupt 61 in NVIC
 }
 
+#ifdef ESP8266_CAPTURE
+// Capture of the UART5 traffic, one record per line in each direction.
+// Records are formatted in interrupt context into a ring buffer and
+// printed from the main loop, so the UART5 interrupt never waits on UART0.
+#define CAPTURESIZE 2048   // must be a power of 2
+#define CAPTURE_RX  0
+#define CAPTURE_TX  1
+#define CAPTURELINE 64     // longer lines are split across records
+char static Capture[CAPTURESIZE]; // formatted records waiting for UART0
+uint32_t volatile CapturePutI;
+uint32_t volatile CaptureGetI;
+uint32_t volatile CaptureLost;    // lines dropped since the last flush
+char static CaptureLine[2][CAPTURELINE];
+uint32_t static CaptureLength[2];
+uint32_t static CaptureStart[2];  // Event_Ticks at the first character
+void static capturePut(char c){
+  Capture[CapturePutI&(CAPTURESIZE-1)] = c;
+  CapturePutI++;
+}
+void static capturePutUDec(uint32_t n){
+  if(n >= 10){
+    capturePutUDec(n/10);
+    n = n%10;
+  }
+  capturePut(n+'0');
+}
+// escapes take at most 4 characters per byte, the rest fits in 16
+void static captureRecord(uint32_t dir){
+  static const char hex[] = "0123456789ABCDEF";
+  uint32_t i; uint8_t c;
+  if((CAPTURESIZE - (CapturePutI - CaptureGetI)) < 4*CaptureLength[dir] + 16){
+    CaptureLost++;
+    CaptureLength[dir] = 0;
+    return;
+  }
+  capturePut((dir == CAPTURE_RX) ? 'R' : 'T');
+  capturePut(' ');
+  capturePutUDec(CaptureStart[dir]*(1000/EVENT_TICK_HZ));
+  capturePut(' ');
+  for(i = 0; i < CaptureLength[dir]; i++){
+    c = CaptureLine[dir][i];
+    if(c == '\n'){
+      capturePut('\\'); capturePut('n');
+    }else if(c == '\r'){
+      capturePut('\\'); capturePut('r');
+    }else if(c == '\\'){
+      capturePut('\\'); capturePut('\\');
+    }else if((c < ' ') || (c > '~')){
+      capturePut('\\'); capturePut('x');
+      capturePut(hex[c >> 4]); capturePut(hex[c & 0x0F]);
+    }else{
+      capturePut(c);
+    }
+  }
+  capturePut('\r');
+  capturePut('\n');
+  CaptureLength[dir] = 0;
+}
+void static captureChar(uint32_t dir, char c){ long sr;
+  sr = StartCritical(); // transmit is captured from more than one context
+  if(CaptureLength[dir] == 0){
+    CaptureStart[dir] = Event_Ticks();
+  }
+  CaptureLine[dir][CaptureLength[dir]] = c;
+  CaptureLength[dir]++;
+  if((c == '\n') || (CaptureLength[dir] == CAPTURELINE)){
+    captureRecord(dir);
+  }
+  EndCritical(sr);
+}
+void ESP8266_CaptureFlush(void){ long sr; uint32_t lost;
+  sr = StartCritical();
+  lost = CaptureLost;
+  CaptureLost = 0;
+  EndCritical(sr);
+  if(lost){
+    UART_OutString("L ");
+    UART_OutUDec(lost);
+    UART_OutString("\r\n");
+  }
+  while(CaptureGetI != CapturePutI){
+    UART_OutChar(Capture[CaptureGetI&(CAPTURESIZE-1)]);
+    CaptureGetI++;
+  }
+}
+#define CAPTURE(dir, c) captureChar(dir, c)
+#else
+#define CAPTURE(dir, c)
+#endif
+
 // copy from hardware RX FIFO to software RX FIFO
-// stop when hardware RX FIFO is empty or software RX FIFO is full
+// stop when hardware RX FIFO is empty or software RX FIFO is full,
+// what is left is copied by ESP8266_GetMessage once it frees a slot
+// a message with a lost or damaged character is dropped
+#ifdef ESP8266_BINARY
+// Binary frames are checked as they end and turned into the same
+// "pin,v1,...,vn,\n" text a CSV message is stored as, so Blynk_to_TM4C
+// reads both. A frame that fails its CRC never reaches the parser.
+#define BINARY_OFFER "cobs1"  // added to the credentials, echoed by a bridge that speaks it
+uint32_t volatile BinaryMode = 0;
+uint8_t static FrameIn[FRAME_MAX_ENCODED];
+uint32_t static FrameInLength = 0;
+uint32_t static FrameInBad = 0;   // 1 when the frame lost a byte, until its delimiter
+uint8_t static FramePayload[FRAME_MAX_PAYLOAD+2];
+// the bridge echoes "cobs1,\n", which Rx5Fifo_Put stores as "cobs1,,\n"
+int static binaryAccepted(const char *message){
+  return strncmp(message, BINARY_OFFER ",", sizeof(BINARY_OFFER ",")-1) == 0;
+}
+void static rx5PutText(const char *pt){
+  while(*pt){
+    Rx5Fifo_Put(*pt);
+    pt++;
+  }
+}
+// payload is a varint pin followed by zig-zag varint values
+void static rx5FrameToText(const uint8_t *payload, uint32_t size){
+  char number[13]; uint32_t value, used, i;
+  for(i = 0; i < size; i += used){    // check it all before storing any of it
+    used = Frame_GetVarint(&payload[i], size-i, &value);
+    if(used == 0){
+      Rx5BadFrames++;
+      return;
+    }
+  }
+  i = Frame_GetVarint(payload, size, &value);
+  if(i == 0){
+    Rx5BadFrames++;   // no pin
+    return;
+  }
+  Fmt_UDec(number, value);
+  rx5PutText(number);
+  for(; i < size; i += used){
+    used = Frame_GetVarint(&payload[i], size-i, &value);
+    Rx5Fifo_Put(',');
+    Fmt_Fixed(number, Frame_UnZigZag(value), 0);
+    rx5PutText(number);
+  }
+  Rx5Fifo_Put('\n');
+}
+void static rx5FrameByte(uint8_t byte){ int32_t size;
+  if(byte != 0){
+    if(FrameInLength < FRAME_MAX_ENCODED){
+      FrameIn[FrameInLength] = byte;
+      FrameInLength++;
+    }else{
+      FrameInBad = 1; // too long to be a frame
+    }
+    return;
+  }
+  if(FrameInLength){  // a lone delimiter is just padding
+    size = FrameInBad ? -1 : Frame_Decode(FrameIn, FrameInLength, FramePayload);
+    if(size < 0){
+      Rx5BadFrames++;
+    }else{
+      rx5FrameToText(FramePayload, size);
+    }
+  }
+  FrameInLength = 0;
+  FrameInBad = 0;
+}
+#endif
 void static copyHardwareToSoftware5(void){
-  char letter;
-  while(((UART5_FR_R&UART_FR_RXFE) == 0) && (Rx5Fifo_Size() < (RX5FIFOSIZE - 1))){
-    letter = UART5_DR_R;
+  uint32_t data; char letter; int lost, damaged;
+  while(((UART5_FR_R&UART_FR_RXFE) == 0) && (rx5Room() >= 3)){
+    data = UART5_DR_R;
+    letter = (char)data;
+    CAPTURE(CAPTURE_RX, letter);
+    lost = damaged = 0;
+    if(data&UART_DR_OE){
+      Rx5Overruns++;  // characters before this one were lost
+      lost = 1;
+    }
+    if(data&(UART_DR_FE|UART_DR_PE|UART_DR_BE)){
+      Rx5LineErrors++;
+      lost = damaged = 1;
+    }
+#ifdef ESP8266_BINARY
+    if(BinaryMode){
+      if(lost){
+        FrameInBad = 1;
+      }
+      if(!damaged){   // a damaged byte could be the delimiter, the frame after pays for it
+        rx5FrameByte((uint8_t)letter);
+      }
+      continue;
+    }
+#endif
+    if(lost){
+      Rx5Discard = 1;
+    }
+    if(damaged){
+      letter = 0;     // cannot be trusted to be the '\n'
+    }
     Rx5Fifo_Put(letter);
   }
 }
-// copy from software TX FIFO to hardware TX FIFO
-// stop when software TX FIFO is empty or hardware TX FIFO is full
+// copy from the transmit queues to hardware TX FIFO, a whole message at a time
+// stop when every tier is empty or hardware TX FIFO is full
 void static copySoftwareToHardware5(void){
   char letter;
-  while(((UART5_FR_R&UART_FR_TXFF) == 0) && (Tx5Fifo_Size() > 0)){
-    Tx5Fifo_Get(&letter);
+  while((UART5_FR_R&UART_FR_TXFF) == 0){
+    if(Tx5Left == 0){
+      if(tx5NextMessage() == FIFOFAIL){
+        return;       // every tier is empty
+      }
+      continue;       // in case the message is empty
+    }
+    letter = Tx5Current[Tx5CurrentI];
+    Tx5CurrentI++;
+    Tx5Left--;
+    Tx5Bytes[Tx5Tier]++;
     UART5_DR_R = letter;
+    CAPTURE(CAPTURE_TX, letter);
+  }
+}
+// queue one message in a tier without waiting
+// when the tier is full the message, or the oldest ones queued, are lost as its policy says
+// messages longer than TX5MAXMESSAGE are cut short
+// return the number of bytes queued, length or 0
+uint32_t static tx5Send(uint32_t tier, const char *data, uint32_t length){
+  uint32_t putI, queued, i; long sr;
+  if(length > TX5MAXMESSAGE){
+    length = TX5MAXMESSAGE;
+  }
+  if((TX5QUEUESIZE-(Tx5PutI[tier]-Tx5GetI[tier])) < (length+TX5HEADER)){
+    if(Tx5Policy[tier] == ESP8266_REJECT){
+      Tx5Rejected[tier]++;
+      return 0;       // the caller still has it and may try again
+    }
+    if(Tx5Policy[tier] == ESP8266_DROP_NEWEST){
+      Tx5Dropped[tier]++;
+      return 0;
+    }
+    sr = StartCritical();   // UART5_Handler must not take a message being dropped
+    while((TX5QUEUESIZE-(Tx5PutI[tier]-Tx5GetI[tier])) < (length+TX5HEADER)){
+      Tx5GetI[tier] += TX5HEADER+(uint8_t)Tx5Queue[tier][Tx5GetI[tier]&(TX5QUEUESIZE-1)];
+      Tx5Dropped[tier]++;
+    }
+    EndCritical(sr);
+  }
+  putI = Tx5PutI[tier];
+  queued = Event_Ticks();
+  Tx5Queue[tier][putI&(TX5QUEUESIZE-1)] = (char)length;
+  Tx5Queue[tier][(putI+1)&(TX5QUEUESIZE-1)] = (char)queued;
+  Tx5Queue[tier][(putI+2)&(TX5QUEUESIZE-1)] = (char)(queued>>8);
+  for(i = 0; i < length; i++){
+    Tx5Queue[tier][(putI+TX5HEADER+i)&(TX5QUEUESIZE-1)] = data[i];
   }
+  Tx5PutI[tier] = putI+TX5HEADER+length;  // the message is complete before it can be taken
+  if((Tx5PutI[tier]-Tx5GetI[tier]) > Tx5HighWater[tier]){
+    Tx5HighWater[tier] = Tx5PutI[tier]-Tx5GetI[tier];
+  }
+  sr = StartCritical();                 // UART5_Handler must not start a message meanwhile
+  copySoftwareToHardware5();
+  UART5_IM_R |= UART_IM_TXIM;           // enable TX FIFO interrupt
+  EndCritical(sr);
+  return length;
 }
 
 // Are there any received messages to be input?
@@ -236,12 +617,18 @@ uint32_t ESP8266_AvailableInput(void){
   return Rx5Fifo_Size();
 }
 // output ASCII character to UART
-// spin if TxFifo is full
-void ESP8266_OutChar(char data){
-  while(Tx5Fifo_Put(data) == FIFOFAIL){};
-  UART5_IM_R &= ~UART_IM_TXIM;          // disable TX FIFO interrupt
-  copySoftwareToHardware5();
-  UART5_IM_R |= UART_IM_TXIM;           // enable TX FIFO interrupt
+// characters are collected into a line, queued in the telemetry tier at its '\n'
+// never waits, a line that finds the tier full is lost as the tier's policy says
+// returns 1 while the line is being built, then the bytes queued or 0 if lost
+uint32_t ESP8266_OutChar(char data){ uint32_t queued;
+  Tx5Line[Tx5LineLength] = data;
+  Tx5LineLength++;
+  if((data == '\n') || (Tx5LineLength == TX5MAXMESSAGE)){
+    queued = tx5Send(ESP8266_TELEMETRY, Tx5Line, Tx5LineLength);
+    Tx5LineLength = 0;
+    return queued;
+  }
+  return 1;
 }
 // at least one of three things has happened:
 // hardware TX FIFO goes from 3 to 2 or less items
@@ -252,7 +639,7 @@ void UART5_Handler(void){
     UART5_ICR_R = UART_ICR_TXIC;        // acknowledge TX FIFO
     // copy from software TX FIFO to hardware TX FIFO
     copySoftwareToHardware5();
-    if(Tx5Fifo_Size() == 0){             // software TX FIFO is empty
+    if(tx5Size() == 0){                 // every transmit queue is empty
       UART5_IM_R &= ~UART_IM_TXIM;      // disable TX FIFO interrupt
     }
   }
@@ -271,29 +658,103 @@ void UART5_Handler(void){
 //------------ESP8266_OutString------------
 // Output String (NULL termination)
 // Input: pointer to a NULL-terminated string to be transferred
-// Output: none
-void ESP8266_OutString(char *pt){
+// Output: characters queued or waiting for their line's '\n'
+uint32_t ESP8266_OutString(char *pt){ uint32_t accepted = 0, line = 0;
   while(*pt){
-    ESP8266_OutChar(*pt);
+    line++;                   // characters of this string in the current line
+    if(ESP8266_OutChar(*pt) == 0){
+      line = 0;               // the line ending here was lost
+    }else if(Tx5LineLength == 0){
+      accepted += line;       // the line ending here was queued
+      line = 0;
+    }
     pt++;
   }
+  return accepted+line;
 }
 
 //-----------------------ESP8266_OutUDec-----------------------
 // Output a 32-bit number in unsigned decimal format
 // Input: 32-bit number to be transferred
-// Output: none
+// Output: characters queued or waiting for their line's '\n'
 // Variable format 1-10 digits with no space before or after
-void ESP8266_OutUDec(uint32_t n){
-// This function uses recursion to convert decimal number
-//   of unspecified length as an ASCII string
-  if(n >= 10){
-    ESP8266_OutUDec(n/10);
-    n = n%10;
+uint32_t ESP8266_OutUDec(uint32_t n){
+  char digits[11];
+  digits[Fmt_UDec(digits, n)] = 0;
+  return ESP8266_OutString(digits);
+}
+
+//-----------------------ESP8266_SendPin-----------------------
+uint32_t ESP8266_SendPin(uint32_t tier, uint32_t pin, int32_t value){
+  char line[32]; uint32_t length;
+#ifdef ESP8266_BINARY
+  uint8_t payload[2*FRAME_MAX_VARINT]; uint8_t frame[FRAME_MAX_ENCODED];
+  uint32_t size;
+  if(BinaryMode){
+    size = Frame_PutVarint(payload, pin);
+    size += Frame_PutVarint(&payload[size], Frame_ZigZag(value));
+    size = Frame_Encode(payload, size, frame);
+    return tx5Send(tier, (char *)frame, size);
   }
-  ESP8266_OutChar(n+'0'); /* n is between 0 and 9 */
+#endif
+  length = Fmt_UDec(line, pin);   // the Virtual Pin #
+  line[length++] = ',';
+  if(value < 0){
+    line[length++] = '-';
+    length += Fmt_UDec(&line[length], 0u - (uint32_t)value);
+  }else{
+    length += Fmt_UDec(&line[length], value); // the current value
+  }
+  memcpy(&line[length], ",0.0\n", 5);  // Null value not used
+  return tx5Send(tier, line, length+5);
+}
+
+//-----------------------ESP8266_SendBatch-----------------------
+uint32_t ESP8266_SendBatch(uint32_t tier, uint32_t pin, uint32_t intervalMs, const int32_t values[], uint32_t num){
+  uint32_t sent;
+#ifdef ESP8266_BINARY
+  uint8_t payload[FRAME_MAX_PAYLOAD]; uint8_t frame[FRAME_MAX_ENCODED];
+  uint32_t size, used;
+  if(BinaryMode){
+    size = Frame_PutBatch(payload, pin, intervalMs, values, num, &used);
+    size = Frame_Encode(payload, size, frame);
+    return tx5Send(tier, (char *)frame, size) ? used : 0;
+  }
+#endif
+  for(sent = 0; sent < num; sent++){   // as many lines as fit without dropping one
+    if((sent > 0) && ((TX5QUEUESIZE-(Tx5PutI[tier]-Tx5GetI[tier])) < (TX5HEADER+TX5CSVLINE))){
+      break;
+    }
+    if(ESP8266_SendPin(tier, pin, values[sent]) == 0){
+      break;
+    }
+  }
+  return sent;
 }
 
+//-----------------------ESP8266_SetTxPolicy-----------------------
+void ESP8266_SetTxPolicy(uint32_t tier, uint32_t policy){
+  if((tier < ESP8266_TIERS) && (policy <= ESP8266_REJECT)){
+    Tx5Policy[tier] = policy;
+  }
+}
+
+//-----------------------ESP8266_GetTxStats-----------------------
+void ESP8266_GetTxStats(uint32_t tier, ESP8266_TxStats *stats){ long sr;
+  if(tier >= ESP8266_TIERS){
+    tier = ESP8266_TIERS-1;
+  }
+  sr = StartCritical();   // one consistent snapshot
+  stats->messages = Tx5Messages[tier];
+  stats->bytes = Tx5Bytes[tier];
+  stats->waiting = Tx5PutI[tier]-Tx5GetI[tier];
+  stats->highWater = Tx5HighWater[tier];
+  stats->maxWaitMs = Tx5WaitMax[tier]*(1000/EVENT_TICK_HZ);
+  stats->meanWaitMs = Tx5Messages[tier] ? (Tx5WaitSum[tier]*(1000/EVENT_TICK_HZ))/Tx5Messages[tier] : 0;
+  stats->dropped = Tx5Dropped[tier];
+  stats->rejected = Tx5Rejected[tier];
+  EndCritical(sr);
+}
 
 // DelayMs
 //  - busy wait n milliseconds
@@ -337,6 +798,9 @@ void ESP8266_Init(void){
   GPIO_PORTE_DEN_R |= 0x0B;       // enable digital I/O on PE3,1,0
   GPIO_PORTE_PCTL_R = (GPIO_PORTE_PCTL_R&0xFFFF0F00);
   GPIO_PORTE_AMSEL_R &= ~0x0B;    // disable analog functionality on PE3,1,0
+#ifdef ESP8266_FLOWCONTROL
+  rts5Init();
+#endif
   UART5_Init(2);                  // Enable ESP8266 Serial Port 
   EnableInterrupts();
 }
@@ -364,6 +828,10 @@ void ESP8266_Reset(void) {
 // This routine sets up the Wifi connection between the TM4C and the
 // hotspot. Enable the DEBUG flags in esp8266.h if you want to watch the transactions.
 void ESP8266_SetupWiFi(void) { 
+#ifdef ESP8266_BINARY
+  int accepted = 0;
+  BinaryMode = 0;       // the handshake is always CSV
+#endif
 #ifdef DEBUG1
   UART_OutString("\r\nIn WiFI_Setup routine\r\n");
   UART_OutString("Waiting for RDY flag from ESP\r\n");
@@ -386,7 +854,15 @@ void ESP8266_SetupWiFi(void) {
   ESP8266_OutChar(',');
   ESP8266_OutString(pass); 
   ESP8266_OutChar(',');       // Extra comma needed for 8266 parser code
-  ESP8266_OutChar('\n');      // Send NL to indicate EOT   
+#ifdef ESP8266_BINARY
+  ESP8266_OutString(BINARY_OFFER);  // a bridge that only speaks CSV ignores the extra field
+  ESP8266_OutChar(',');
+#endif
+  if(ESP8266_OutChar('\n') == 0){      // Send NL to indicate EOT
+#ifdef DEBUG1
+    UART_OutString("Credentials were not queued\r\n");
+#endif
+  }
 
 #ifdef DEBUG1
   UART_OutString(auth);    
@@ -418,11 +894,23 @@ void ESP8266_SetupWiFi(void) {
     DelayMs(500);
   }
   while(ESP8266_GetMessage(RxMessage)){
+#ifdef ESP8266_BINARY
+    if(binaryAccepted(RxMessage)){
+      accepted = 1;
+    }
+#endif
   }
 #ifdef DEBUG1
   UART_OutString("\n\rRDY went low\n\r");
 #endif 
   Rx5Fifo_Init(); // flush buffer
+#ifdef ESP8266_BINARY
+  FrameInLength = FrameInBad = 0;
+  BinaryMode = accepted;  // from the next byte on
+#ifdef DEBUG1
+  UART_OutString(BinaryMode ? "Binary frames\r\n" : "CSV messages\r\n");
+#endif
+#endif
 
 #ifdef DEBUG3
   Output_Color(ST7735_YELLOW);
@@ -17,6 +17,31 @@
 // comment out either/both to remove debugging
 #define DEBUG1                // UART0 Debug output
 #define DEBUG3                // ST7735 Debug output
+// uncomment to log every line on UART5, both directions, on UART0 (needs DEBUG1)
+// for Tools/esp8266replay.py
+//#define ESP8266_CAPTURE
+// uncomment to drive RTS on PD2 high while the receive FIFO is nearly full,
+// for an ESP8266 bridge that holds its output while RTS is high
+//#define ESP8266_FLOWCONTROL
+// uncomment to offer binary frames (frame.h) to the bridge in ESP8266_SetupWiFi,
+// CSV is used if the bridge does not accept
+//#define ESP8266_BINARY
+
+// longest message ESP8266_GetMessage returns, counting the ",\n" and null
+// it ends with; messages are stored in a shared 512 byte arena however long
+#define ESP8266_MESSAGESIZE 128
+
+// uplink priority tiers, each with its own 256 byte queue; a message
+// only goes out when every higher tier is empty
+#define ESP8266_ALERT     0   // alarms and commands to the other board
+#define ESP8266_TELEMETRY 1   // periodic readings and ESP8266_OutChar lines
+#define ESP8266_BULK      2   // history uploads
+#define ESP8266_TIERS     3
+
+// what happens to a message sent to a full tier, nothing ever waits for room
+#define ESP8266_DROP_OLDEST 0   // queued messages are dropped, oldest first, until it fits
+#define ESP8266_DROP_NEWEST 1   // the new message is dropped
+#define ESP8266_REJECT      2   // the new message is refused, the caller may send it again later
 
 // Initialize PE5,4,3,1,0 for interface to ESP8266
 // Uses interrupt driven UART5 on PE5,4
@@ -32,9 +57,11 @@ void ESP8266_SetupWiFi(void);
 
 
 
-// remove a message from front of index FIFO
-// datapt points to an empty data buffer of MESSAGESIZE character
-// if successful a message is copied from the FIFO into data buffer
+// remove a message from front of the receive FIFO
+// datapt points to an empty data buffer of ESP8266_MESSAGESIZE characters
+// if successful a message is copied from the FIFO into data buffer,
+// ending in ",\n" followed by a null; a message longer than
+// ESP8266_MESSAGESIZE-4 characters is cut short
 // return FIFOSUCCESS if successful
 // return FIFOFAIL if the FIFO is empty (no messages)
 int ESP8266_GetMessage(char *datapt);
@@ -42,22 +69,129 @@ int ESP8266_GetMessage(char *datapt);
 
 
 // output ASCII character to UART5, interrupt driven
-// spin if Tx5Fifo is full
-void ESP8266_OutChar(char data);
+// characters are queued in the telemetry tier a line at a time, once the
+// '\n' is written; never waits, see ESP8266_SetTxPolicy
+// returns 1 for a character held for its line; for the '\n' (or a
+// character that fills the line) the bytes of the line queued, 0 if the
+// tier dropped or rejected the line
+uint32_t ESP8266_OutChar(char data);
 
 //------------ESP8266_OutString------------
 // Output String (NULL termination)
-// interrupt-driven, spin on Tx5Fifo full
+// interrupt-driven, never waits for a full telemetry queue
 // Input: pointer to a NULL-terminated string to be transferred
-// Output: none
-void ESP8266_OutString(char *pt);
+// Output: characters queued or still waiting for their line's '\n',
+//         less than the string's length if a line it ended was lost
+uint32_t ESP8266_OutString(char *pt);
 
 //-----------------------ESP8266_OutUDec-----------------------
 // Output a 32-bit number in unsigned decimal format
 // Input: 32-bit number to be transferred
-// Output: none
+// Output: characters queued or still waiting for their line's '\n',
+//         as ESP8266_OutString
 // Variable format 1-10 digits with no space before or after
-void ESP8266_OutUDec(uint32_t n);
+uint32_t ESP8266_OutUDec(uint32_t n);
+
+//-----------------------ESP8266_SendPin-----------------------
+// Sends a value to a virtual pin, as "pin,value,0.0\n" or as a binary
+// frame holding a varint pin and a zig-zag varint value once the bridge
+// has accepted binary frames; never waits, see ESP8266_SetTxPolicy
+// Input: tier   ESP8266_ALERT, ESP8266_TELEMETRY or ESP8266_BULK
+//        pin    virtual pin number
+//        value  value to send
+// Output: bytes queued, 0 if the message was dropped or rejected
+uint32_t ESP8266_SendPin(uint32_t tier, uint32_t pin, int32_t value);
+
+//-----------------------ESP8266_SendBatch-----------------------
+// Sends the oldest of a run of samples for one virtual pin: as many as
+// fit in one delta coded batch frame (see frame.h), or when the bridge
+// only speaks CSV a "pin,value,0.0\n" line each for as many as the tier
+// has room for without dropping or refusing one
+// Input: tier        ESP8266_ALERT, ESP8266_TELEMETRY or ESP8266_BULK
+//        pin         virtual pin number
+//        intervalMs  time between samples
+//        values      samples, oldest first
+//        num         number of samples, at least 1
+// Output: number of samples queued, call again with the rest; 0 if the
+//         tier was full, see ESP8266_SetTxPolicy
+uint32_t ESP8266_SendBatch(uint32_t tier, uint32_t pin, uint32_t intervalMs, const int32_t values[], uint32_t num);
+
+//-----------------------ESP8266_MessageCount-----------------------
+// Number of messages taken from the receive FIFO since reset
+// Input: none
+// Output: message count, wraps at 2^32
+uint32_t ESP8266_MessageCount(void);
+
+typedef struct {
+  uint32_t overruns;    // characters lost in the UART5 hardware FIFO
+  uint32_t lineErrors;  // characters with a framing, parity or break error
+  uint32_t dropped;     // messages dropped because the receive FIFO was full
+  uint32_t truncated;   // messages cut short because they were too long
+  uint32_t highWater;   // most messages ever waiting in the receive FIFO
+  uint32_t highWaterBytes; // most bytes of the receive arena ever in use
+  uint32_t badFrames;   // binary frames dropped for a bad CRC or framing
+  uint32_t waiting;     // messages waiting now
+} ESP8266_RxStats;
+
+//-----------------------ESP8266_GetRxStats-----------------------
+// Receive error and occupancy counters since reset, copied atomically
+// A message with an overrun or line error in it is dropped
+// Input: stats  filled in
+// Output: none
+void ESP8266_GetRxStats(ESP8266_RxStats *stats);
+
+typedef struct {
+  uint32_t messages;    // messages that have started going out
+  uint32_t bytes;       // bytes of them sent
+  uint32_t waiting;     // bytes queued now, 3 per message more than sent
+  uint32_t highWater;   // most bytes ever queued
+  uint32_t maxWaitMs;   // longest time from queued to going out
+  uint32_t meanWaitMs;  // mean of that time
+  uint32_t dropped;     // messages lost to a full tier, new or queued
+  uint32_t rejected;    // messages refused by a full ESP8266_REJECT tier
+} ESP8266_TxStats;
+
+//-----------------------ESP8266_SetTxPolicy-----------------------
+// Chooses what a full tier does with a new message. The alert and
+// telemetry tiers start as ESP8266_DROP_OLDEST, since the newest reading
+// or alarm matters most, and the bulk tier as ESP8266_REJECT, so history
+// is retried rather than lost
+// Input: tier    ESP8266_ALERT, ESP8266_TELEMETRY or ESP8266_BULK
+//        policy  ESP8266_DROP_OLDEST, ESP8266_DROP_NEWEST or ESP8266_REJECT
+// Output: none
+void ESP8266_SetTxPolicy(uint32_t tier, uint32_t policy);
+
+//-----------------------ESP8266_GetTxStats-----------------------
+// Transmit counters of one tier since reset, copied atomically
+// Waits are timed with Event_Ticks, to 1000/EVENT_TICK_HZ ms, and end when the
+// first byte goes to the UART5 hardware FIFO, up to 16 characters ahead of the wire
+// Input: tier   ESP8266_ALERT, ESP8266_TELEMETRY or ESP8266_BULK
+//        stats  filled in
+// Output: none
+void ESP8266_GetTxStats(uint32_t tier, ESP8266_TxStats *stats);
+
+//-----------------------ESP8266_OutputQueueSize-----------------------
+// Number of bytes waiting in the transmit queues of all tiers
+// Input: none
+// Output: 0 to 256*ESP8266_TIERS
+uint32_t ESP8266_OutputQueueSize(void);
+
+//-----------------------ESP8266_CaptureFlush-----------------------
+// Prints the UART5 lines captured since the last call on UART0, one per line:
+//   R <ms> <text>   received from the ESP8266
+//   T <ms> <text>   sent to the ESP8266
+//   L <count>       lines lost because the capture buffer was full
+// <ms> is when the line started, on the Event_Tick clock. The text is escaped,
+// \n \r \\ and \xHH, and a line ends with \n unless it was longer than
+// 64 characters and continues in the next record.
+// Call from the main loop. Does nothing unless ESP8266_CAPTURE is defined
+// Input: none
+// Output: none
+#ifdef ESP8266_CAPTURE
+void ESP8266_CaptureFlush(void);
+#else
+#define ESP8266_CaptureFlush()
+#endif
 
 #endif
   
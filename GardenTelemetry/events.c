@@ -0,0 +1,86 @@
+// events.c
+// Runs on TM4C123
+// Event flags posted by interrupts and consumed by the main loop.
+// Interrupts are disabled between checking the flags and executing WFI,
+// so an event posted in that gap still wakes the processor: a pending
+// interrupt ends WFI even while it is masked, and it runs as soon as
+// the mask is lifted.
+// SysTick counts down at the bus clock (SysTick_Init), and the cycles it
+// counts between entering WFI and waking are summed once per second.
+// Its interrupt, the PF0 heartbeat, is one of the things that wakes WFI,
+// which only costs a pass round the empty wait loop.
+
+#include <stdint.h>
+#include "events.h"
+#include "../inc/tm4c123gh6pm.h"
+
+#define BUS_CLOCK 80000000
+
+void DisableInterrupts(void); // Disable interrupts
+void EnableInterrupts(void);  // Enable interrupts
+long StartCritical (void);    // previous I bit, disable interrupts
+void EndCritical(long sr);    // restore I bit to previous value
+void WaitForInterrupt(void);  // low power mode
+
+uint32_t volatile Events = 0;
+uint32_t volatile SleepCycles = 0;     // asleep so far this second
+uint32_t volatile TickCount = 0;
+uint32_t volatile CpuLoad = 100;
+
+void Event_Post(uint32_t events)
+{
+	long sr = StartCritical();
+	Events |= events;
+	EndCritical(sr);
+}
+
+void Event_Tick(void)
+{
+	long sr = StartCritical();
+	TickCount++;
+	if(TickCount % (EVENT_TICK_HZ / EVENT_FRAME_HZ) == 0) {Events |= EVENT_FRAME;}
+	if(TickCount % EVENT_TICK_HZ == 0)
+	{
+		uint32_t asleep = SleepCycles / (BUS_CLOCK / 100);
+		CpuLoad = asleep < 100 ? 100 - asleep : 0;
+		SleepCycles = 0;
+	}
+	EndCritical(sr);
+}
+
+// SysTick counts down and reloads, each sleep is far shorter than one period
+uint32_t static elapsed(uint32_t start, uint32_t end)
+{
+	if(end <= start) {return start - end;}
+	return start + (NVIC_ST_RELOAD_R & 0x00FFFFFF) + 1 - end;
+}
+
+uint32_t Event_WaitFrame(void)
+{
+	uint32_t events;
+	DisableInterrupts();
+	//wait for a frame slot with something to draw, events before the slot are kept
+	while((Events & EVENT_FRAME) == 0 || (Events & ~EVENT_FRAME) == 0)
+	{
+		if(Events == EVENT_FRAME) {Events = 0;}		//nothing happened this frame
+		uint32_t start = NVIC_ST_CURRENT_R;
+		WaitForInterrupt();
+		SleepCycles += elapsed(start, NVIC_ST_CURRENT_R);
+		EnableInterrupts();		//let the interrupt that woke us run
+		DisableInterrupts();
+	}
+	events = Events;
+	Events = 0;
+	EnableInterrupts();
+	return events;
+}
+
+uint32_t Event_Ticks(void)
+{
+	return TickCount;
+}
+
+uint32_t Event_CpuLoad(void)
+{
+	return CpuLoad;
+}
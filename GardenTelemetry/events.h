@@ -0,0 +1,51 @@
+// events.h
+// Runs on TM4C123
+// Event flags posted by interrupts and consumed by the main loop.
+// The main loop sleeps in WaitForInterrupt until an event is pending,
+// and screen updates are held back to at most EVENT_FRAME_HZ frames
+// per second no matter how many events arrive in between.
+// Time spent asleep is measured with SysTick to report the CPU load.
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stdint.h>
+
+#define EVENT_TICK_HZ    100       // rate Event_Tick is called, the Blynk poll rate
+#define EVENT_FRAME_HZ   10        // most screen updates per second
+
+#define EVENT_CLOCK      0x01      // a second went by on Timer0
+#define EVENT_MESSAGE    0x02      // a message from the app was handled
+#define EVENT_SAMPLE     0x04      // new sensor readings were recorded
+#define EVENT_MODE       0x08      // the screen mode changed
+#define EVENT_FRAME      0x80      // a frame may be drawn, posted by Event_Tick
+
+//------------Event_Post------------
+// Sets event flags, safe to call from an interrupt
+// Inputs:  events   one or more EVENT_ flags
+// Outputs: none
+void Event_Post(uint32_t events);
+
+//------------Event_Tick------------
+// Frame and load timekeeping, called EVENT_TICK_HZ times a second from a timer interrupt
+// Inputs:  none
+// Outputs: none
+void Event_Tick(void);
+
+//------------Event_WaitFrame------------
+// Sleeps until a frame is due and something has happened since the last one
+// Inputs:  none
+// Outputs: the EVENT_ flags posted since the last frame, EVENT_FRAME included
+uint32_t Event_WaitFrame(void);
+
+//------------Event_Ticks------------
+// Inputs:  none
+// Outputs: calls to Event_Tick since reset, EVENT_TICK_HZ per second
+uint32_t Event_Ticks(void);
+
+//------------Event_CpuLoad------------
+// Inputs:  none
+// Outputs: percent of the last second the CPU was awake, 0 to 100
+uint32_t Event_CpuLoad(void);
+
+#endif
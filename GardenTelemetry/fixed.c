@@ -1,15 +1,33 @@
-#include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include "ST7735.h"
+#include "qformat.h"
 
-#define decimalPlace	3
+#define decimalDigits	2
 #define printWidth	6
 #define	upperRange	10000
 #define lowerRange	-10000
 #define yStartDraw	32
 #define xStartDraw	0
+
+/****************outRightAligned***************
+ Shifts a formatted number right within its buffer so that it
+ fills exactly printWidth characters, then sends it to the LCD
+ Inputs:  text    buffer of printWidth+1 characters holding the number
+          length  characters in the number, at most printWidth
+*/
+void outRightAligned(char *text, uint32_t length){
+	int32_t shift = printWidth - length;
+	for(int32_t i = printWidth; i >= shift; i--){
+		text[i] = text[i - shift];
+	}
+	for(int32_t i = 0; i < shift; i++){
+		text[i] = ' ';
+	}
+	ST7735_OutString(text);
+}
+
 /****************ST7735_sDecOut2***************
  converts fixed point number to LCD
  format signed 32-bit with resolution 0.01
@@ -26,35 +44,14 @@ Parameter LCD display
 -12345    "-**.**"
  */ 
 void ST7735_sDecOut2(int32_t n){
-	bool negFlag = n < 0;
-		
 	if(n >= upperRange){
-		printf(" **.**");
+		ST7735_OutString(" **.**");
 	}else if(n <= lowerRange){
-		printf("-**.**");
+		ST7735_OutString("-**.**");
 	}else{
-		char fixedNum[printWidth];
-		
-		n = abs(n);
-		for(int i = printWidth - 1; i >= 0; i--){
-			if(i == decimalPlace){
-				fixedNum[i] = '.';
-			}else{
-				if((n != 0) || (i >= (decimalPlace - 1))){
-					fixedNum[i] = (n % 10) + '0';
-					n = n / 10;
-				}else{
-					fixedNum[i] = (negFlag) ? '-' : ' ';
-					for(int j = i - 1; j >= 0; j--){
-						fixedNum[j] = ' ';
-					}
-					i = -1;
-				}
-			}
-		}
-		ST7735_OutString(fixedNum);
+		char fixedNum[printWidth + 1];
+		outRightAligned(fixedNum, Fmt_Fixed(fixedNum, n, decimalDigits));
 	}
-		
 }
 
 
@@ -81,27 +78,10 @@ Parameter LCD display
 */
 void ST7735_uBinOut6(uint32_t n){
 	if(n >= 64000){
-		printf("***.**");
+		ST7735_OutString("***.**");
 	}else{
-		n = (n * 100) / 64;
-		char fixedNum[printWidth];
-		
-		for(int i = printWidth - 1; i >= 0; i--){
-			if(i == decimalPlace){
-				fixedNum[i] = '.';
-			}else{
-				if((n != 0) || (i >= (decimalPlace - 1))){
-					fixedNum[i] = (n % 10) + '0';
-					n = n / 10;
-				}else{
-					for(int j = i; j >= 0; j--){
-						fixedNum[j] = ' ';
-					}
-					i = -1; 
-				}
-			}
-		}
-		ST7735_OutString(fixedNum);
+		char fixedNum[printWidth + 1];
+		outRightAligned(fixedNum, Fmt_Fixed(fixedNum, (n * 100) / 64, decimalDigits));
 	}
 }
 
@@ -110,6 +90,32 @@ int32_t xMax;
 int32_t yMin;
 int32_t yMax;
 
+// XY plot area is 128x128 pixels, x 0 to 127 and y 32 to 159
+// scale factors are rounded reciprocals of the data ranges in Q32 fixed point,
+// computed once per XYplotInit so each point costs two multiplies. An offset
+// is never more than its range, so offset*scale stays below 2^40 and no
+// 32 bit range is too wide to plot.
+#define plotSize	128
+#define scaleShift	32
+uint64_t xScale;
+uint64_t yScale;
+// one bit per plotted pixel, a column of 128 rows is 4 words
+uint32_t plotBits[plotSize][plotSize / 32];
+uint8_t dirtyTop[plotSize];		//rows touched by the current XYplot call, per column
+uint8_t dirtyBottom[plotSize];
+
+// (plotSize-1)/(max-min) in Q32, rounded
+uint64_t static plotScale(int32_t min, int32_t max){
+	uint64_t range = (max > min) ? (uint32_t)max - (uint32_t)min : 1;
+	return (((uint64_t)(plotSize - 1) << scaleShift) + range / 2) / range;
+}
+
+// pixel 0 to plotSize-1 for an offset from the bottom of the axis, rounded
+int32_t static plotPixel(uint32_t offset, uint64_t scale){
+	uint64_t pixel = ((uint64_t)offset * scale + (1ULL << (scaleShift - 1))) >> scaleShift;
+	return (pixel > plotSize - 1) ? plotSize - 1 : (int32_t)pixel;
+}
+
 /**************ST7735_XYplotInit***************
  Specify the X and Y axes for an x-y scatter plot
  Draw the title and clear the plot area
@@ -126,6 +132,13 @@ void ST7735_XYplotInit(char *title, int32_t minX, int32_t maxX, int32_t minY, in
 	xMax = maxX;
 	yMin = minY;
 	yMax = maxY;
+	xScale = plotScale(minX, maxX);
+	yScale = plotScale(minY, maxY);
+	for(int i = 0; i < plotSize; i++){
+		for(int j = 0; j < plotSize / 32; j++){
+			plotBits[i][j] = 0;
+		}
+	}
 	
 	ST7735_FillScreen(ST7735_BLACK);
 	ST7735_FillRect(0, 32, ST7735_TFTWIDTH, ST7735_TFTHEIGHT, ST7735_WHITE);
@@ -143,7 +156,8 @@ void ST7735_XYplotInit(char *title, int32_t minX, int32_t maxX, int32_t minY, in
  Outputs: int32_t value of the point under the new range
 */
 int32_t resize(int32_t point, int32_t newMax, int32_t newMin, int32_t oldMax, int32_t oldMin){
-	return ((point - oldMin) * (newMax - newMin)) / ((oldMax - oldMin) + newMin);
+	if(oldMax == oldMin) {return newMin;}
+	return (int32_t)(((int64_t)(point - oldMin) * (newMax - newMin)) / (oldMax - oldMin)) + newMin;
 }
 
 /**************ST7735_XYplot***************
@@ -154,16 +168,31 @@ int32_t resize(int32_t point, int32_t newMax, int32_t newMin, int32_t oldMax, in
  Outputs: none
  assumes ST7735_XYplotInit has been previously called
  neglect any points outside the minX maxY minY maxY bounds
+ points are collected per column and each changed column is sent as one window
 */
 void ST7735_XYplot(uint32_t num, int32_t bufX[], int32_t bufY[]){
-	int32_t resizedX;
-	int32_t resizedY;
-
-	for(int i = 0; i < num; i++){
+	int32_t column;
+	int32_t row;
+	
+	for(int i = 0; i < plotSize; i++){
+		dirtyTop[i] = plotSize;
+		dirtyBottom[i] = 0;
+	}
+	// transform every point into the bitmap, noting which rows of each column changed
+	for(uint32_t i = 0; i < num; i++){
 		if(bufX[i] <= xMax && bufX[i] >= xMin && bufY[i] <= yMax && bufY[i] >= yMin){
-			resizedX = resize(bufX[i], ST7735_TFTWIDTH, xStartDraw, xMax, xMin);
-			resizedY = resize(bufY[i], ST7735_TFTHEIGHT, yStartDraw, yMax, yMin);
-			ST7735_DrawPixel(resizedX, ST7735_TFTHEIGHT - resizedY, ST7735_BLUE);		//yaxis needs to be inverted do to origin being at the top left
+			column = plotPixel((uint32_t)bufX[i] - (uint32_t)xMin, xScale);
+			row = (plotSize - 1) - plotPixel((uint32_t)bufY[i] - (uint32_t)yMin, yScale);		//yaxis needs to be inverted do to origin being at the top left
+			plotBits[column][row >> 5] |= 1UL << (row & 31);
+			if(row < dirtyTop[column]) {dirtyTop[column] = row;}
+			if(row > dirtyBottom[column]) {dirtyBottom[column] = row;}
+		}
+	}
+	// stream each touched column as one address window
+	for(column = 0; column < plotSize; column++){
+		if(dirtyTop[column] <= dirtyBottom[column]){
+			ST7735_DrawColumnBits(xStartDraw + column, yStartDraw + dirtyTop[column], dirtyBottom[column] - dirtyTop[column] + 1,
+			                      plotBits[column], dirtyTop[column], ST7735_BLUE, ST7735_WHITE);
 		}
 	}
 }
@@ -174,33 +203,161 @@ int32_t abs1(int32_t x)
 	else{return -x;}
 }
 
-void ST7735_Line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color)
+// Cohen-Sutherland outcodes used by ST7735_LineClipped
+#define CLIP_LEFT   0x01
+#define CLIP_RIGHT  0x02
+#define CLIP_TOP    0x04
+#define CLIP_BOTTOM 0x08
+
+int32_t static outcode(int32_t x, int32_t y, int32_t left, int32_t top, int32_t right, int32_t bottom)
 {
-	int Ydiff = y2 - y1;
-	int Xdiff = x2 - x1;
-	int currentX = x1;
-	int currentY = y1;
+	int32_t code = 0;
+	if(x < left) {code |= CLIP_LEFT;}
+	else if(x > right) {code |= CLIP_RIGHT;}
+	if(y < top) {code |= CLIP_TOP;}
+	else if(y > bottom) {code |= CLIP_BOTTOM;}
+	return code;
+}
+
+/**************fillClipped***************
+ FillRect that trims the rectangle to the screen first,
+ since the driver only clips the right and bottom edges
+*/
+void static fillClipped(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+	if(x < 0) {w += x; x = 0;}
+	if(y < 0) {h += y; y = 0;}
+	if(x + w > ST7735_TFTWIDTH) {w = ST7735_TFTWIDTH - x;}
+	if(y + h > ST7735_TFTHEIGHT) {h = ST7735_TFTHEIGHT - y;}
+	if(w <= 0 || h <= 0) {return;}
+	ST7735_FillRect(x, y, w, h, color);
+}
+
+/**************drawRun***************
+ Draws one straight run of a Bresenham line as a single address window
+ Inputs:  from, to     start and end of the run along the major axis
+          across       position of the run on the minor axis
+          horizontal   1 if the run is along x, 0 if along y
+          thickness    width of the line in pixels
+          color        color of the line
+*/
+void static drawRun(int32_t from, int32_t to, int32_t across, int32_t horizontal, int32_t thickness, uint16_t color)
+{
+	int32_t start = (from < to) ? from : to;
+	int32_t length = abs1(to - from) + 1;
+	//clipped at every thickness, ST7735_ThickLine passes its points through unchecked
+	if(horizontal) {fillClipped(start, across - thickness / 2, length, thickness, color);}
+	else {fillClipped(across - thickness / 2, start, thickness, length, color);}
+}
+
+/**************drawLineRuns***************
+ Integer Bresenham walk from (x1,y1) to (x2,y2). Consecutive pixels that
+ share a row (or column for steep lines) are sent as one run, so a line
+ costs one address window per step on the minor axis instead of one per pixel
+*/
+void static drawLineRuns(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t thickness, uint16_t color)
+{
+	int32_t Xdiff = abs1(x2 - x1);
+	int32_t Ydiff = abs1(y2 - y1);
+	int32_t stepX = (x2 >= x1) ? 1 : -1;
+	int32_t stepY = (y2 >= y1) ? 1 : -1;
+	int32_t currentX = x1;
+	int32_t currentY = y1;
+	int32_t runStart;
+	int32_t error;
 	
-	int stepNumber = 1;
-	int signOfStep = 0;
-	if(abs1(Xdiff) > abs1(Ydiff))
+	if(Xdiff >= Ydiff)
 	{
-		signOfStep = Xdiff / abs(Xdiff);
-		while (currentX != x2)
+		error = Xdiff / 2;
+		runStart = x1;
+		for(int32_t i = 0; i < Xdiff; i++)
 		{
-			ST7735_DrawPixel(currentX, currentY, color);
-			currentX += signOfStep;
-			currentY = (y1 * Xdiff + signOfStep * Ydiff * stepNumber++) / (Xdiff); 
+			error -= Ydiff;
+			if(error < 0)
+			{
+				drawRun(runStart, currentX, currentY, 1, thickness, color);
+				currentY += stepY;
+				error += Xdiff;
+				runStart = currentX + stepX;
+			}
+			currentX += stepX;
 		}
-	} 
-	else 
+		drawRun(runStart, x2, currentY, 1, thickness, color);
+	}
+	else
 	{
-		signOfStep = Ydiff / abs(Ydiff);
-		while(currentY != y2)
+		error = Ydiff / 2;
+		runStart = y1;
+		for(int32_t i = 0; i < Ydiff; i++)
 		{
-			ST7735_DrawPixel(currentX, currentY, color);
-			currentX = (x1 * Ydiff + signOfStep * Xdiff * stepNumber++) / (Ydiff);
-			currentY += signOfStep;
+			error -= Xdiff;
+			if(error < 0)
+			{
+				drawRun(runStart, currentY, currentX, 0, thickness, color);
+				currentX += stepX;
+				error += Ydiff;
+				runStart = currentY + stepY;
+			}
+			currentY += stepY;
 		}
+		drawRun(runStart, y2, currentX, 0, thickness, color);
+	}
+}
+
+/**************ST7735_LineClipped***************
+ Draw a line between two points, clipped to a rectangle
+ Inputs:  Start point x and y
+          Second point x and y
+          color of the line
+          left, top, right, bottom  inclusive clipping rectangle
+ Outputs: none
+ points may lie off screen, only the part inside the rectangle is drawn
+*/
+void ST7735_LineClipped(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color,
+                        int16_t left, int16_t top, int16_t right, int16_t bottom)
+{
+	int32_t ax = x1, ay = y1, bx = x2, by = y2;
+	
+	if(left < 0) {left = 0;}
+	if(top < 0) {top = 0;}
+	if(right > ST7735_TFTWIDTH - 1) {right = ST7735_TFTWIDTH - 1;}
+	if(bottom > ST7735_TFTHEIGHT - 1) {bottom = ST7735_TFTHEIGHT - 1;}
+	if(left > right || top > bottom) {return;}
+	
+	int32_t codeA = outcode(ax, ay, left, top, right, bottom);
+	int32_t codeB = outcode(bx, by, left, top, right, bottom);
+	while(codeA | codeB)
+	{
+		if(codeA & codeB) {return;}		//both ends on the same outside side
+		int32_t code = codeA ? codeA : codeB;
+		int32_t x, y;
+		if(code & CLIP_TOP) {x = ax + (bx - ax) * (top - ay) / (by - ay); y = top;}
+		else if(code & CLIP_BOTTOM) {x = ax + (bx - ax) * (bottom - ay) / (by - ay); y = bottom;}
+		else if(code & CLIP_LEFT) {y = ay + (by - ay) * (left - ax) / (bx - ax); x = left;}
+		else {y = ay + (by - ay) * (right - ax) / (bx - ax); x = right;}
+		if(code == codeA) {ax = x; ay = y; codeA = outcode(ax, ay, left, top, right, bottom);}
+		else {bx = x; by = y; codeB = outcode(bx, by, left, top, right, bottom);}
 	}
+	drawLineRuns(ax, ay, bx, by, 1, color);
+}
+
+/**************ST7735_ThickLine***************
+ Draw a line between two points that is several pixels wide
+ Inputs:  Start point x and y
+          Second point x and y
+          thickness of the line in pixels, measured across the minor axis
+          color of the line
+ Outputs: none
+ each run is drawn as one filled rectangle, clipped to the screen,
+ so points may lie off screen
+*/
+void ST7735_ThickLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t thickness, uint16_t color)
+{
+	if(thickness == 0) {return;}
+	drawLineRuns(x1, y1, x2, y2, thickness, color);
+}
+
+void ST7735_Line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color)
+{
+	ST7735_LineClipped(x1, y1, x2, y2, color, 0, 0, ST7735_TFTWIDTH - 1, ST7735_TFTHEIGHT - 1);
 }
@@ -4,7 +4,6 @@
 // put your name here
 // put the date here
 
-#include <stdio.h>
 #include <stdint.h>
 /****************ST7735_sDecOut2***************
  converts fixed point number to LCD
@@ -68,6 +67,7 @@ void ST7735_XYplotInit(char *title, int32_t minX, int32_t maxX, int32_t minY, in
  Outputs: none
  assumes ST7735_XYplotInit has been previously called
  neglect any points outside the minX maxY minY maxY bounds
+ points are collected per column and each changed column is sent as one window
 */
 void ST7735_XYplot(uint32_t num, int32_t bufX[], int32_t bufY[]);
 
@@ -77,9 +77,30 @@ void ST7735_XYplot(uint32_t num, int32_t bufX[], int32_t bufY[]);
           Second point x and y
           color of the line
  Outputs: none
- assumes ST7735_XYplotInit has been previously called 
+ Bresenham line, each horizontal or vertical run is one address window
+ the part of the line off the screen is clipped
 */
 void ST7735_Line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color);
 
+/**************ST7735_LineClipped***************
+ Draw a line between two points, clipped to a rectangle
+ Inputs:  Start point x and y
+          Second point x and y
+          color of the line
+          left, top, right, bottom  inclusive clipping rectangle
+ Outputs: none
+ points may lie off screen, only the part inside the rectangle is drawn
+*/
+void ST7735_LineClipped(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color,
+                        int16_t left, int16_t top, int16_t right, int16_t bottom);
 
-
+/**************ST7735_ThickLine***************
+ Draw a line between two points that is several pixels wide
+ Inputs:  Start point x and y
+          Second point x and y
+          thickness of the line in pixels, measured across the minor axis
+          color of the line
+ Outputs: none
+ each run is drawn as one filled rectangle, clipped to the screen
+*/
+void ST7735_ThickLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t thickness, uint16_t color);
@@ -0,0 +1,127 @@
+// frame.c
+// Runs on TM4C123
+// COBS framing with a CRC16 and varint fields for the ESP8266 link.
+// Everything works on caller supplied buffers and nothing is kept
+// between calls, so the receive interrupt and the senders can share it.
+
+#include <stdint.h>
+#include "frame.h"
+
+uint32_t Frame_PutVarint(uint8_t *buf, uint32_t value)
+{
+	uint32_t length = 0;
+	while(value >= 0x80)
+	{
+		buf[length++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	buf[length++] = (uint8_t)value;
+	return length;
+}
+
+uint32_t Frame_GetVarint(const uint8_t *buf, uint32_t size, uint32_t *value)
+{
+	uint32_t result = 0;
+	for(uint32_t i = 0; i < size && i < FRAME_MAX_VARINT; i++)
+	{
+		result |= (uint32_t)(buf[i] & 0x7F) << (7 * i);
+		if((buf[i] & 0x80) == 0)
+		{
+			*value = result;
+			return i + 1;
+		}
+	}
+	return 0;
+}
+
+uint32_t Frame_ZigZag(int32_t value)
+{
+	return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+int32_t Frame_UnZigZag(uint32_t value)
+{
+	return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+uint32_t Frame_PutBatch(uint8_t *payload, uint32_t pin, uint32_t intervalMs,
+                        const int32_t values[], uint32_t num, uint32_t *used)
+{
+	uint8_t field[FRAME_MAX_VARINT];
+	uint32_t size = Frame_PutVarint(payload, FRAME_BATCH);
+	size += Frame_PutVarint(&payload[size], pin);
+	size += Frame_PutVarint(&payload[size], intervalMs);
+	uint32_t i;
+	for(i = 0; i < num; i++)
+	{
+		//differences wrap like the host decoder's 32-bit sum, so any pair of samples is exact
+		int32_t delta = (i == 0) ? values[0] : (int32_t)((uint32_t)values[i] - (uint32_t)values[i - 1]);
+		uint32_t length = Frame_PutVarint(field, Frame_ZigZag(delta));
+		if(size + length > FRAME_MAX_PAYLOAD) {break;}		//the header leaves room for the keyframe
+		for(uint32_t j = 0; j < length; j++) {payload[size++] = field[j];}
+	}
+	*used = i;
+	return size;
+}
+
+uint16_t Frame_Crc16(const uint8_t *buf, uint32_t size)
+{
+	uint16_t crc = 0xFFFF;
+	while(size--)
+	{
+		crc ^= (uint16_t)(*buf++) << 8;
+		for(int bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+uint32_t Frame_Encode(const uint8_t *payload, uint32_t size, uint8_t *out)
+{
+	uint16_t crc = Frame_Crc16(payload, size);
+	uint32_t codeAt = 0;		//where the length of the current block goes
+	uint32_t length = 1;
+	uint8_t code = 1;
+	for(uint32_t i = 0; i < size + 2; i++)
+	{
+		uint8_t byte = (i < size) ? payload[i] : (i == size) ? (uint8_t)(crc >> 8) : (uint8_t)crc;
+		if(byte != 0)
+		{
+			out[length++] = byte;
+			code++;
+		}
+		if(byte == 0 || code == 0xFF)		//block ends at a zero or after 254 data bytes
+		{
+			out[codeAt] = code;
+			codeAt = length++;
+			code = 1;
+		}
+	}
+	out[codeAt] = code;
+	out[length++] = 0;
+	return length;
+}
+
+int32_t Frame_Decode(const uint8_t *frame, uint32_t size, uint8_t *payload)
+{
+	uint32_t length = 0;
+	uint32_t i = 0;
+	while(i < size)
+	{
+		uint8_t code = frame[i++];
+		if(code == 0 || i + code - 1 > size) {return -1;}
+		if(length + code - 1 > FRAME_MAX_PAYLOAD + 2) {return -1;}
+		for(uint8_t j = 1; j < code; j++) {payload[length++] = frame[i++];}
+		if(code < 0xFF && i < size)		//a zero was removed here, none after the last block
+		{
+			if(length == FRAME_MAX_PAYLOAD + 2) {return -1;}
+			payload[length++] = 0;
+		}
+	}
+	if(length < 2) {return -1;}
+	length -= 2;
+	if(Frame_Crc16(payload, length) != (uint16_t)((payload[length] << 8) | payload[length + 1])) {return -1;}
+	return length;
+}
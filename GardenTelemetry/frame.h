@@ -0,0 +1,83 @@
+// frame.h
+// Runs on TM4C123
+// Binary frames for the ESP8266 link. A frame is a payload followed by
+// its CRC16 (CCITT, polynomial 0x1021, initial 0xFFFF, high byte first),
+// COBS encoded so it holds no zero bytes, and ended by a zero byte.
+// Payloads are built from varints, 7 bits per byte with the low group
+// first and the top bit set on all but the last byte; signed values are
+// zig-zag mapped first so small negative numbers stay short.
+// A batch payload starts with FRAME_BATCH, then the virtual pin, the
+// sample interval in ms and the oldest sample as a keyframe; every later
+// sample is sent as its difference from the one before. Each frame
+// starts from its own keyframe, so a lost frame only loses its samples.
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdint.h>
+
+#define FRAME_MAX_PAYLOAD  64
+#define FRAME_MAX_VARINT   5     // bytes in the longest 32-bit varint
+#define FRAME_BATCH        256   // first varint of a batch, above every Blynk virtual pin
+// COBS adds one byte per 254, the CRC two and the delimiter one
+#define FRAME_MAX_ENCODED  (FRAME_MAX_PAYLOAD + 2 + (FRAME_MAX_PAYLOAD + 2)/254 + 2)
+
+//------------Frame_PutVarint------------
+// Inputs:  buf    room for FRAME_MAX_VARINT bytes
+//          value  number to write
+// Outputs: bytes written, 1 to FRAME_MAX_VARINT
+uint32_t Frame_PutVarint(uint8_t *buf, uint32_t value);
+
+//------------Frame_GetVarint------------
+// Inputs:  buf    varint to read
+//          size   bytes available in buf
+//          value  set to the number read
+// Outputs: bytes used, 0 if buf ends inside the varint or it is too long
+uint32_t Frame_GetVarint(const uint8_t *buf, uint32_t size, uint32_t *value);
+
+//------------Frame_ZigZag------------
+// Maps 0, -1, 1, -2, ... to 0, 1, 2, 3, ...
+// Inputs:  value  signed number
+// Outputs: unsigned number for Frame_PutVarint
+uint32_t Frame_ZigZag(int32_t value);
+
+//------------Frame_UnZigZag------------
+// Inputs:  value  number from Frame_GetVarint
+// Outputs: signed number Frame_ZigZag was given
+int32_t Frame_UnZigZag(uint32_t value);
+
+//------------Frame_Crc16------------
+// Inputs:  buf   bytes to check
+//          size  number of bytes
+// Outputs: CRC16-CCITT of buf
+uint16_t Frame_Crc16(const uint8_t *buf, uint32_t size);
+
+//------------Frame_PutBatch------------
+// Builds a batch payload from as many samples as fit in FRAME_MAX_PAYLOAD
+// Inputs:  payload     room for FRAME_MAX_PAYLOAD bytes
+//          pin         virtual pin the samples belong to
+//          intervalMs  time between samples
+//          values      samples, oldest first
+//          num         number of samples, at least 1
+//          used        set to the number of samples encoded, at least 1
+// Outputs: payload size
+uint32_t Frame_PutBatch(uint8_t *payload, uint32_t pin, uint32_t intervalMs,
+                        const int32_t values[], uint32_t num, uint32_t *used);
+
+//------------Frame_Encode------------
+// Adds the CRC, COBS encodes and appends the zero delimiter
+// Inputs:  payload  bytes to send
+//          size     0 to FRAME_MAX_PAYLOAD
+//          out      room for FRAME_MAX_ENCODED bytes
+// Outputs: bytes written to out, the last one is the delimiter
+uint32_t Frame_Encode(const uint8_t *payload, uint32_t size, uint8_t *out);
+
+//------------Frame_Decode------------
+// Undoes Frame_Encode for one frame received without its delimiter
+// Inputs:  frame    encoded bytes, none of them zero
+//          size     number of bytes
+//          payload  room for FRAME_MAX_PAYLOAD+2 bytes, the CRC is decoded there too
+// Outputs: payload size, or -1 if the frame is malformed, too long or fails the CRC
+int32_t Frame_Decode(const uint8_t *frame, uint32_t size, uint8_t *payload);
+
+#endif
@@ -0,0 +1,93 @@
+// histogram.c
+// Runs on TM4C123
+// Fixed size binned histogram of ADC readings, used by graphSensorsMode.
+// Bins start out minBinWidth readings wide, centered on the first
+// sample. A reading outside the range doubles the bin width, so the
+// range grows toward that reading while keeping the old data.
+
+#include <stdint.h>
+#include "histogram.h"
+
+void Histogram_Init(Histogram *hist, uint32_t numBins, uint32_t minBinWidth)
+{
+	if(numBins > HISTOGRAM_MAX_BINS) {numBins = HISTOGRAM_MAX_BINS;}
+	if(numBins < 2) {numBins = 2;}
+	if(minBinWidth < 1) {minBinWidth = 1;}
+	hist->numBins = numBins & ~1;
+	hist->minBinWidth = minBinWidth;
+	Histogram_Clear(hist);
+}
+
+void Histogram_Clear(Histogram *hist)
+{
+	for(uint32_t i = 0; i < hist->numBins; i++) {hist->counts[i] = 0;}
+	hist->binWidth = hist->minBinWidth;
+	hist->low = 0;
+	hist->total = 0;
+	hist->maxCount = 0;
+	hist->minReading = 0;
+	hist->maxReading = 0;
+}
+
+// doubles the bin width, merging pairs of bins
+// growDown keeps the old data in the upper half so the range extends left
+void static widen(Histogram *hist, int growDown)
+{
+	uint32_t half = hist->numBins / 2;
+	uint16_t maxCount = 0;
+	if(growDown)
+	{
+		for(int32_t i = hist->numBins - 1; i >= (int32_t)half; i--)
+		{
+			uint32_t merged = hist->counts[2 * i - hist->numBins] + hist->counts[2 * i - hist->numBins + 1];
+			hist->counts[i] = (merged > 0xFFFF) ? 0xFFFF : merged;
+		}
+		for(uint32_t i = 0; i < half; i++) {hist->counts[i] = 0;}
+		hist->low -= hist->binWidth * hist->numBins;
+	}
+	else
+	{
+		for(uint32_t i = 0; i < half; i++)
+		{
+			uint32_t merged = hist->counts[2 * i] + hist->counts[2 * i + 1];
+			hist->counts[i] = (merged > 0xFFFF) ? 0xFFFF : merged;
+		}
+		for(uint32_t i = half; i < hist->numBins; i++) {hist->counts[i] = 0;}
+	}
+	hist->binWidth *= 2;
+	for(uint32_t i = 0; i < hist->numBins; i++)
+	{
+		if(hist->counts[i] > maxCount) {maxCount = hist->counts[i];}
+	}
+	hist->maxCount = maxCount;
+}
+
+void Histogram_Put(Histogram *hist, int32_t reading)
+{
+	if(hist->total == 0)
+	{
+		hist->low = reading - (int32_t)(hist->binWidth * hist->numBins / 2);
+		hist->minReading = reading;
+		hist->maxReading = reading;
+	}
+	while(reading < hist->low) {widen(hist, 1);}
+	while(reading >= hist->low + (int32_t)(hist->binWidth * hist->numBins)) {widen(hist, 0);}
+	
+	uint32_t bin = (reading - hist->low) / hist->binWidth;
+	if(hist->counts[bin] < 0xFFFF) {hist->counts[bin]++;}
+	if(hist->counts[bin] > hist->maxCount) {hist->maxCount = hist->counts[bin];}
+	if(reading < hist->minReading) {hist->minReading = reading;}
+	if(reading > hist->maxReading) {hist->maxReading = reading;}
+	hist->total++;
+}
+
+uint32_t Histogram_Bin(const Histogram *hist, uint32_t bin)
+{
+	if(bin >= hist->numBins) {return 0;}
+	return hist->counts[bin];
+}
+
+int32_t Histogram_BinStart(const Histogram *hist, uint32_t bin)
+{
+	return hist->low + (int32_t)(bin * hist->binWidth);
+}
@@ -0,0 +1,61 @@
+// histogram.h
+// Runs on TM4C123
+// Fixed size binned histogram of ADC readings, used by graphSensorsMode.
+// Samples are added one at a time, the bins cover a range that grows
+// to fit the data, and clearing only touches the bins.
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+
+#define HISTOGRAM_MAX_BINS  128    // one bin per plot column, must be even
+
+typedef struct
+{
+	uint16_t counts[HISTOGRAM_MAX_BINS];
+	uint32_t numBins;        // bins in use, even, 2 to HISTOGRAM_MAX_BINS
+	uint32_t minBinWidth;    // width the range starts at after a clear
+	uint32_t binWidth;       // readings per bin
+	int32_t low;             // reading at the left edge of bin 0
+	uint32_t total;          // samples since the last clear
+	uint16_t maxCount;       // tallest bin since the last clear
+	int32_t minReading;
+	int32_t maxReading;
+} Histogram;
+
+//------------Histogram_Init------------
+// Sets the bin count and clears the histogram
+// Inputs:  hist         histogram to initialize
+//          numBins      number of bins, rounded down to even, at most HISTOGRAM_MAX_BINS
+//          minBinWidth  smallest number of readings per bin, at least 1
+// Outputs: none
+void Histogram_Init(Histogram *hist, uint32_t numBins, uint32_t minBinWidth);
+
+//------------Histogram_Clear------------
+// Empties every bin and forgets the range, O(numBins)
+// Inputs:  hist  histogram to clear
+// Outputs: none
+void Histogram_Clear(Histogram *hist);
+
+//------------Histogram_Put------------
+// Adds one reading. If the reading falls outside the current range the
+// bin width is doubled, merging pairs of bins, until it fits
+// Inputs:  hist     histogram to update
+//          reading  sample to count
+// Outputs: none
+void Histogram_Put(Histogram *hist, int32_t reading);
+
+//------------Histogram_Bin------------
+// Inputs:  hist  histogram to read
+//          bin   0 to numBins-1
+// Outputs: number of readings counted in that bin
+uint32_t Histogram_Bin(const Histogram *hist, uint32_t bin);
+
+//------------Histogram_BinStart------------
+// Inputs:  hist  histogram to read
+//          bin   0 to numBins-1
+// Outputs: smallest reading that falls in that bin
+int32_t Histogram_BinStart(const Histogram *hist, uint32_t bin);
+
+#endif
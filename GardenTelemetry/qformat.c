@@ -0,0 +1,130 @@
+// qformat.c
+// Runs on TM4C123
+// Binary fixed-point arithmetic in Q16.16 and Q8.8 and decimal
+// formatting without printf. Products and quotients are formed in 64
+// bits (32 bits for Q8.8), rounded to nearest, and saturated rather
+// than allowed to wrap. Digits come from repeated division by the
+// constant 10, which the compiler turns into a multiply, so no power
+// of ten tables are needed.
+
+#include <stdint.h>
+#include "qformat.h"
+
+int32_t static saturate32(int64_t x)
+{
+	if(x > 0x7FFFFFFF) {return 0x7FFFFFFF;}
+	if(x < -0x7FFFFFFF - 1) {return -0x7FFFFFFF - 1;}
+	return (int32_t)x;
+}
+
+int16_t static saturate16(int32_t x)
+{
+	if(x > 0x7FFF) {return 0x7FFF;}
+	if(x < -0x8000) {return -0x8000;}
+	return (int16_t)x;
+}
+
+// divides rounding to nearest, halves away from zero
+int64_t static divRound(int64_t n, int64_t d)
+{
+	if((n < 0) != (d < 0)) {return (n - d / 2) / d;}
+	return (n + d / 2) / d;
+}
+
+int32_t Q16_ToInt(q16_t a)
+{
+	return (int32_t)divRound(a, Q16_ONE);
+}
+
+q16_t Q16_Mul(q16_t a, q16_t b)
+{
+	return saturate32(divRound((int64_t)a * b, Q16_ONE));
+}
+
+q16_t Q16_Div(q16_t a, q16_t b)
+{
+	if(b == 0) {return (a < 0) ? Q16_MIN : Q16_MAX;}
+	return saturate32(divRound((int64_t)a * Q16_ONE, b));
+}
+
+q16_t Q16_Recip(q16_t a)
+{
+	return Q16_Div(Q16_ONE, a);
+}
+
+q8_t Q8_Mul(q8_t a, q8_t b)
+{
+	return saturate16((int32_t)divRound((int32_t)a * b, Q8_ONE));
+}
+
+q8_t Q8_Div(q8_t a, q8_t b)
+{
+	if(b == 0) {return (a < 0) ? Q8_MIN : Q8_MAX;}
+	return saturate16((int32_t)divRound((int32_t)a * Q8_ONE, b));
+}
+
+q8_t Q8_Recip(q8_t a)
+{
+	return Q8_Div(Q8_ONE, a);
+}
+
+q16_t Q16_FromScaled(int32_t value, int32_t scale)
+{
+	return saturate32(divRound((int64_t)value * Q16_ONE, scale));
+}
+
+int32_t Q16_ToScaled(q16_t a, int32_t scale)
+{
+	return saturate32(divRound((int64_t)a * scale, Q16_ONE));
+}
+
+uint32_t Fmt_UDecPad(char *buf, uint32_t n, uint32_t width, char pad)
+{
+	char digits[10];
+	uint32_t count = 0;
+	uint32_t length = 0;
+	do
+	{
+		digits[count++] = '0' + (n % 10);
+		n = n / 10;
+	}while(n);
+	while(width > count) {buf[length++] = pad; width--;}
+	while(count) {buf[length++] = digits[--count];}
+	buf[length] = 0;
+	return length;
+}
+
+uint32_t Fmt_UDec(char *buf, uint32_t n)
+{
+	return Fmt_UDecPad(buf, n, 0, ' ');
+}
+
+uint32_t Fmt_Fixed(char *buf, int32_t value, uint32_t decimals)
+{
+	uint32_t length = 0;
+	uint32_t magnitude;
+	uint32_t divisor = 1;
+	if(decimals > 9) {decimals = 9;}
+	for(uint32_t i = 0; i < decimals; i++) {divisor *= 10;}
+	if(value < 0)
+	{
+		buf[length++] = '-';
+		magnitude = 0 - (uint32_t)value;
+	}
+	else {magnitude = value;}
+	length += Fmt_UDec(&buf[length], magnitude / divisor);
+	if(decimals)
+	{
+		buf[length++] = '.';
+		length += Fmt_UDecPad(&buf[length], magnitude % divisor, decimals, '0');
+	}
+	return length;
+}
+
+uint32_t Fmt_Q16(char *buf, q16_t a, uint32_t decimals)
+{
+	int32_t scale = 1;
+	if(decimals > 4) {decimals = 4;}
+	for(uint32_t i = 0; i < decimals; i++) {scale *= 10;}
+	return Fmt_Fixed(buf, Q16_ToScaled(a, scale), decimals);
+}
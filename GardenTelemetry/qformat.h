@@ -0,0 +1,100 @@
+// qformat.h
+// Runs on TM4C123
+// Binary fixed-point arithmetic in Q16.16 and Q8.8, conversions to and
+// from the decimal fixed-point used by the sensor and plot code, and
+// decimal formatting into caller supplied buffers without printf.
+
+#ifndef QFORMAT_H
+#define QFORMAT_H
+
+#include <stdint.h>
+
+typedef int32_t q16_t;    // 16 integer bits, 16 fraction bits
+typedef int16_t q8_t;     // 8 integer bits, 8 fraction bits
+
+#define Q16_ONE   ((q16_t)0x00010000)
+#define Q16_MAX   ((q16_t)0x7FFFFFFF)
+#define Q16_MIN   ((q16_t)0x80000000)
+#define Q8_ONE    ((q8_t)0x0100)
+#define Q8_MAX    ((q8_t)0x7FFF)
+#define Q8_MIN    ((q8_t)0x8000)
+
+#define Q16_FromInt(i)  ((q16_t)((i) * Q16_ONE))
+#define Q8_FromInt(i)   ((q8_t)((i) * Q8_ONE))
+#define Q16_FromQ8(q)   ((q16_t)(q) * 256)
+#define Q8_FromQ16(q)   ((q8_t)((q) >> 8))
+
+//------------Q16_ToInt------------
+// Inputs:  a  Q16.16 value
+// Outputs: a rounded to the nearest integer, halves away from zero
+int32_t Q16_ToInt(q16_t a);
+
+//------------Q16_Mul------------
+// Inputs:  a, b  Q16.16 factors
+// Outputs: rounded product, saturated to Q16_MIN..Q16_MAX
+q16_t Q16_Mul(q16_t a, q16_t b);
+
+//------------Q16_Div------------
+// Inputs:  a  Q16.16 dividend
+//          b  Q16.16 divisor
+// Outputs: a/b, saturated; division by zero returns Q16_MAX or Q16_MIN by sign of a
+q16_t Q16_Div(q16_t a, q16_t b);
+
+//------------Q16_Recip------------
+// Inputs:  a  Q16.16 value
+// Outputs: 1/a, saturated as Q16_Div
+q16_t Q16_Recip(q16_t a);
+
+//------------Q8_Mul, Q8_Div, Q8_Recip------------
+// Q8.8 versions of the above, rounded and saturated to Q8_MIN..Q8_MAX
+q8_t Q8_Mul(q8_t a, q8_t b);
+q8_t Q8_Div(q8_t a, q8_t b);
+q8_t Q8_Recip(q8_t a);
+
+//------------Q16_FromScaled------------
+// Converts decimal fixed-point to Q16.16, e.g. resolution 0.001 has scale 1000
+// Inputs:  value  integer part of the decimal fixed-point number
+//          scale  units per 1.0, greater than 0
+// Outputs: value/scale in Q16.16, rounded and saturated
+q16_t Q16_FromScaled(int32_t value, int32_t scale);
+
+//------------Q16_ToScaled------------
+// Converts Q16.16 to decimal fixed-point
+// Inputs:  a      Q16.16 value
+//          scale  units per 1.0, greater than 0
+// Outputs: a*scale rounded to the nearest integer, saturated to 32 bits
+int32_t Q16_ToScaled(q16_t a, int32_t scale);
+
+//------------Fmt_UDec------------
+// Writes n in decimal with no padding
+// Inputs:  buf  room for at least 11 characters
+//          n    value to format
+// Outputs: number of characters written, buf is null terminated
+uint32_t Fmt_UDec(char *buf, uint32_t n);
+
+//------------Fmt_UDecPad------------
+// Writes n in decimal, right aligned in width characters
+// Inputs:  buf    room for at least width+1 (or 11) characters
+//          n      value to format
+//          width  minimum number of characters
+//          pad    fill character, e.g. '0' or ' '
+// Outputs: number of characters written, buf is null terminated
+uint32_t Fmt_UDecPad(char *buf, uint32_t n, uint32_t width, char pad);
+
+//------------Fmt_Fixed------------
+// Writes a signed decimal fixed-point number, e.g. (-102, 2) gives "-1.02"
+// Inputs:  buf       room for at least 13 characters
+//          value     integer part of the decimal fixed-point number
+//          decimals  digits after the point, 0 to 9
+// Outputs: number of characters written, buf is null terminated
+uint32_t Fmt_Fixed(char *buf, int32_t value, uint32_t decimals);
+
+//------------Fmt_Q16------------
+// Writes a Q16.16 number rounded to the given number of decimals
+// Inputs:  buf       room for at least 13 characters
+//          a         Q16.16 value
+//          decimals  digits after the point, 0 to 4
+// Outputs: number of characters written, buf is null terminated
+uint32_t Fmt_Q16(char *buf, q16_t a, uint32_t decimals);
+
+#endif
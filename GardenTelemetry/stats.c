@@ -0,0 +1,196 @@
+// stats.c
+// Runs on TM4C123
+// Constant memory streaming statistics for each garden sensor.
+// Moments use Welford's update with the mean held in Q16 fixed point, so
+// no sample buffer is kept and no floating point is used. Quantiles use
+// the P-squared algorithm of Jain and Chlamtac: five markers per quantile
+// whose heights (Q16) are nudged by parabolic interpolation as samples arrive.
+
+#include <stdint.h>
+#include "stats.h"
+
+#define Q 16                  // fraction bits of the fixed point values
+#define ONE (1 << Q)
+
+typedef struct
+{
+	int32_t height[5];        // marker heights, Q16
+	int32_t position[5];      // actual marker positions, 1 based
+	int32_t desired[5];       // desired marker positions, Q16
+	int32_t increment[5];     // desired position step per sample, Q16
+	uint32_t count;
+} Quantile;
+
+typedef struct
+{
+	uint32_t count;
+	int32_t mean;             // Q16
+	int64_t m2;               // sum of squared differences, Q16
+	uint32_t min;
+	uint32_t max;
+	Quantile median;
+	Quantile p95;
+} SensorStats;
+
+SensorStats Stats[STATS_NUM_SENSORS];
+Stats_Summary Summary[STATS_NUM_SENSORS];
+uint32_t WindowSamples = 120;
+
+// p is the quantile in Q16, 0.5 is ONE/2
+void static quantileInit(Quantile *quant, int32_t p)
+{
+	quant->count = 0;
+	quant->increment[0] = 0;
+	quant->increment[1] = p / 2;
+	quant->increment[2] = p;
+	quant->increment[3] = (ONE + p) / 2;
+	quant->increment[4] = ONE;
+}
+
+int32_t static parabolic(Quantile *quant, int i, int32_t d)
+{
+	int32_t *q = quant->height;
+	int32_t *n = quant->position;
+	int64_t right = (int64_t)(n[i] - n[i-1] + d) * (q[i+1] - q[i]) / (n[i+1] - n[i]);
+	int64_t left = (int64_t)(n[i+1] - n[i] - d) * (q[i] - q[i-1]) / (n[i] - n[i-1]);
+	return q[i] + (int32_t)(d * (right + left) / (n[i+1] - n[i-1]));
+}
+
+int32_t static linear(Quantile *quant, int i, int32_t d)
+{
+	int32_t *q = quant->height;
+	int32_t *n = quant->position;
+	return q[i] + d * (q[i+d] - q[i]) / (n[i+d] - n[i]);
+}
+
+void static quantilePut(Quantile *quant, uint32_t value)
+{
+	int32_t x = value << Q;
+	int32_t *q = quant->height;
+	int32_t *n = quant->position;
+	int k;
+	
+	if(quant->count < 5)
+	{
+		// insertion sort the first five samples into the markers
+		int i = quant->count;
+		while(i > 0 && q[i-1] > x) {q[i] = q[i-1]; i--;}
+		q[i] = x;
+		quant->count++;
+		if(quant->count == 5)
+		{
+			for(i = 0; i < 5; i++)
+			{
+				n[i] = i + 1;
+				quant->desired[i] = ONE + 4 * quant->increment[i];
+			}
+		}
+		return;
+	}
+	quant->count++;
+	
+	if(x < q[0]) {q[0] = x; k = 0;}
+	else if(x < q[1]) {k = 0;}
+	else if(x < q[2]) {k = 1;}
+	else if(x < q[3]) {k = 2;}
+	else if(x <= q[4]) {k = 3;}
+	else {q[4] = x; k = 3;}
+	
+	for(int i = k + 1; i < 5; i++) {n[i]++;}
+	for(int i = 0; i < 5; i++) {quant->desired[i] += quant->increment[i];}
+	
+	for(int i = 1; i <= 3; i++)
+	{
+		int32_t d = quant->desired[i] - (n[i] << Q);
+		if((d >= ONE && n[i+1] - n[i] > 1) || (d <= -ONE && n[i-1] - n[i] < -1))
+		{
+			d = (d > 0) ? 1 : -1;
+			int32_t candidate = parabolic(quant, i, d);
+			if(q[i-1] < candidate && candidate < q[i+1]) {q[i] = candidate;}
+			else {q[i] = linear(quant, i, d);}
+			n[i] += d;
+		}
+	}
+}
+
+// until five samples arrive the markers are just the sorted samples
+uint32_t static quantileValue(Quantile *quant, int32_t p)
+{
+	int32_t estimate;
+	if(quant->count == 0) {return 0;}
+	if(quant->count < 5) {estimate = quant->height[(int32_t)(((int64_t)p * (quant->count - 1) + ONE / 2) >> Q)];}
+	else {estimate = quant->height[2];}
+	return (estimate + ONE / 2) >> Q;
+}
+
+uint32_t static isqrt(uint32_t n)
+{
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
+	while(bit > n) {bit >>= 2;}
+	while(bit)
+	{
+		if(n >= root + bit) {n -= root + bit; root = (root >> 1) + bit;}
+		else {root >>= 1;}
+		bit >>= 2;
+	}
+	return root;
+}
+
+void static clearSensor(SensorStats *stats)
+{
+	stats->count = 0;
+	stats->mean = 0;
+	stats->m2 = 0;
+	stats->min = 0xFFFFFFFF;
+	stats->max = 0;
+	quantileInit(&stats->median, ONE / 2);
+	quantileInit(&stats->p95, ONE * 95 / 100);
+}
+
+void Stats_Init(uint32_t windowSamples)
+{
+	WindowSamples = (windowSamples < 5) ? 5 : windowSamples;
+	for(uint32_t i = 0; i < STATS_NUM_SENSORS; i++)
+	{
+		clearSensor(&Stats[i]);
+		Summary[i].count = 0;
+	}
+}
+
+int Stats_Put(uint32_t sensor, uint32_t value)
+{
+	if(sensor >= STATS_NUM_SENSORS) {return 0;}
+	SensorStats *stats = &Stats[sensor];
+	
+	// Welford: mean += delta/n, m2 += delta*(x - new mean)
+	stats->count++;
+	int32_t x = value << Q;
+	int32_t delta = x - stats->mean;
+	stats->mean += delta / (int32_t)stats->count;
+	stats->m2 += ((int64_t)delta * (x - stats->mean)) >> Q;
+	if(value < stats->min) {stats->min = value;}
+	if(value > stats->max) {stats->max = value;}
+	quantilePut(&stats->median, value);
+	quantilePut(&stats->p95, value);
+	
+	if(stats->count < WindowSamples) {return 0;}
+	
+	Stats_Summary *summary = &Summary[sensor];
+	summary->count = stats->count;
+	summary->mean = (stats->mean + ONE / 2) >> Q;
+	summary->variance = (stats->m2 > 0) ? (uint32_t)((stats->m2 / (stats->count - 1) + ONE / 2) >> Q) : 0;
+	summary->stdDev = isqrt(summary->variance);
+	summary->min = stats->min;
+	summary->max = stats->max;
+	summary->median = quantileValue(&stats->median, ONE / 2);
+	summary->p95 = quantileValue(&stats->p95, ONE * 95 / 100);
+	clearSensor(stats);
+	return 1;
+}
+
+void Stats_GetSummary(uint32_t sensor, Stats_Summary *summary)
+{
+	if(sensor >= STATS_NUM_SENSORS) {summary->count = 0; return;}
+	*summary = Summary[sensor];
+}
@@ -0,0 +1,48 @@
+// stats.h
+// Runs on TM4C123
+// Constant memory streaming statistics for each garden sensor.
+// Each sensor keeps Welford running moments and P-squared estimators for
+// the median and 95th percentile over a tumbling window of samples.
+// When a window fills, its summary is latched for reporting and the
+// estimators start over.
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+
+#define STATS_NUM_SENSORS  3
+
+typedef struct
+{
+	uint32_t count;      // samples in the window
+	uint32_t mean;       // rounded to the nearest ADC count
+	uint32_t stdDev;     // sample standard deviation, ADC counts
+	uint32_t variance;   // sample variance, ADC counts squared
+	uint32_t min;
+	uint32_t max;
+	uint32_t median;     // P-squared estimate
+	uint32_t p95;        // P-squared estimate
+} Stats_Summary;
+
+//------------Stats_Init------------
+// Clears every sensor and sets the window length
+// Inputs:  windowSamples  samples per window, at least 5
+// Outputs: none
+void Stats_Init(uint32_t windowSamples);
+
+//------------Stats_Put------------
+// Adds one sample to a sensor's window, safe to call from an interrupt
+// Inputs:  sensor  0 to STATS_NUM_SENSORS-1
+//          value   12-bit reading
+// Outputs: 1 if this sample completed a window and a new summary is ready, 0 otherwise
+int Stats_Put(uint32_t sensor, uint32_t value);
+
+//------------Stats_GetSummary------------
+// Copies the summary of the last completed window
+// Inputs:  sensor   0 to STATS_NUM_SENSORS-1
+//          summary  filled in, count is 0 if no window has completed yet
+// Outputs: none
+void Stats_GetSummary(uint32_t sensor, Stats_Summary *summary);
+
+#endif
@@ -0,0 +1,136 @@
+// timeseries.c
+// Runs on TM4C123
+// Fixed memory history of each garden sensor at three resolutions.
+// Each sensor has three rings plus running accumulators for the minute
+// and hour in progress. When a minute fills, its bucket is pushed into
+// the minute ring and folded into the hour accumulator, and likewise
+// for hours, so a sample costs a constant amount of work.
+
+#include <stdint.h>
+#include "timeseries.h"
+
+long StartCritical (void);    // previous I bit, disable interrupts
+void EndCritical(long sr);    // restore I bit to previous value
+
+typedef struct
+{
+	uint32_t sum;
+	uint32_t count;
+	uint16_t min;
+	uint16_t max;
+} Accumulator;
+
+typedef struct
+{
+	uint16_t raw[TS_RAW_SIZE];
+	TimeSeries_Bucket minutes[TS_MINUTE_SIZE];
+	TimeSeries_Bucket hours[TS_HOUR_SIZE];
+	uint32_t rawPutI;        // total raw samples stored
+	uint32_t minutePutI;     // total minute buckets stored
+	uint32_t hourPutI;       // total hour buckets stored
+	Accumulator minute;      // raw samples of the minute in progress
+	Accumulator hour;        // minute buckets of the hour in progress
+} SensorHistory;
+
+SensorHistory History[TS_NUM_SENSORS];
+uint32_t SamplesPerMinute = 60;
+
+void static clearAccumulator(Accumulator *acc)
+{
+	acc->sum = 0;
+	acc->count = 0;
+	acc->min = 0xFFFF;
+	acc->max = 0;
+}
+
+void static accumulate(Accumulator *acc, uint16_t min, uint16_t mean, uint16_t max)
+{
+	acc->sum += mean;
+	acc->count++;
+	if(min < acc->min) {acc->min = min;}
+	if(max > acc->max) {acc->max = max;}
+}
+
+TimeSeries_Bucket static toBucket(const Accumulator *acc)
+{
+	TimeSeries_Bucket bucket;
+	bucket.min = acc->min;
+	bucket.mean = acc->sum / acc->count;
+	bucket.max = acc->max;
+	return bucket;
+}
+
+void TimeSeries_Init(uint32_t samplesPerMinute)
+{
+	long sr = StartCritical();
+	SamplesPerMinute = (samplesPerMinute > 0) ? samplesPerMinute : 1;
+	for(uint32_t i = 0; i < TS_NUM_SENSORS; i++)
+	{
+		History[i].rawPutI = 0;
+		History[i].minutePutI = 0;
+		History[i].hourPutI = 0;
+		clearAccumulator(&History[i].minute);
+		clearAccumulator(&History[i].hour);
+	}
+	EndCritical(sr);
+}
+
+void TimeSeries_Put(uint32_t sensor, uint16_t value)
+{
+	if(sensor >= TS_NUM_SENSORS) {return;}
+	SensorHistory *history = &History[sensor];
+	
+	history->raw[history->rawPutI & (TS_RAW_SIZE - 1)] = value;
+	history->rawPutI++;
+	
+	accumulate(&history->minute, value, value, value);
+	if(history->minute.count < SamplesPerMinute) {return;}
+	
+	TimeSeries_Bucket minute = toBucket(&history->minute);
+	history->minutes[history->minutePutI % TS_MINUTE_SIZE] = minute;
+	history->minutePutI++;
+	clearAccumulator(&history->minute);
+	
+	accumulate(&history->hour, minute.min, minute.mean, minute.max);
+	if(history->hour.count < 60) {return;}
+	
+	history->hours[history->hourPutI % TS_HOUR_SIZE] = toBucket(&history->hour);
+	history->hourPutI++;
+	clearAccumulator(&history->hour);
+}
+
+uint32_t TimeSeries_Read(uint32_t sensor, uint32_t level, uint32_t num, TimeSeries_Bucket points[])
+{
+	if(sensor >= TS_NUM_SENSORS) {return 0;}
+	SensorHistory *history = &History[sensor];
+	uint32_t stored, size, first;
+	
+	long sr = StartCritical();
+	if(level == TS_RAW) {stored = history->rawPutI; size = TS_RAW_SIZE;}
+	else if(level == TS_MINUTE) {stored = history->minutePutI; size = TS_MINUTE_SIZE;}
+	else {stored = history->hourPutI; size = TS_HOUR_SIZE;}
+	
+	if(stored < size) {size = stored;}
+	if(num > size) {num = size;}
+	first = stored - num;
+	for(uint32_t i = 0; i < num; i++)
+	{
+		if(level == TS_RAW)
+		{
+			uint16_t value = history->raw[(first + i) & (TS_RAW_SIZE - 1)];
+			points[i].min = value;
+			points[i].mean = value;
+			points[i].max = value;
+		}
+		else if(level == TS_MINUTE) {points[i] = history->minutes[(first + i) % TS_MINUTE_SIZE];}
+		else {points[i] = history->hours[(first + i) % TS_HOUR_SIZE];}
+	}
+	EndCritical(sr);
+	return num;
+}
+
+uint16_t TimeSeries_Latest(uint32_t sensor)
+{
+	if(sensor >= TS_NUM_SENSORS || History[sensor].rawPutI == 0) {return 0;}
+	return History[sensor].raw[(History[sensor].rawPutI - 1) & (TS_RAW_SIZE - 1)];
+}
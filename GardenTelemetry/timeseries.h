@@ -0,0 +1,58 @@
+// timeseries.h
+// Runs on TM4C123
+// Fixed memory history of each garden sensor at three resolutions:
+// the most recent raw samples, one min/mean/max bucket per minute for
+// the last hour, and one bucket per hour for the last day.
+// Full minutes roll into the minute ring and full hours into the hour
+// ring as samples arrive, so reading any level never rescans raw data.
+
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include <stdint.h>
+
+#define TS_NUM_SENSORS   3
+#define TS_RAW_SIZE      128   // raw samples kept per sensor, power of 2
+#define TS_MINUTE_SIZE   60    // one hour of minute buckets
+#define TS_HOUR_SIZE     24    // one day of hour buckets
+
+#define TS_RAW     0
+#define TS_MINUTE  1
+#define TS_HOUR    2
+
+typedef struct
+{
+	uint16_t min;
+	uint16_t mean;
+	uint16_t max;
+} TimeSeries_Bucket;
+
+//------------TimeSeries_Init------------
+// Empties the history of every sensor
+// Inputs:  samplesPerMinute  number of TimeSeries_Put calls per sensor per minute
+// Outputs: none
+void TimeSeries_Init(uint32_t samplesPerMinute);
+
+//------------TimeSeries_Put------------
+// Records one sample, safe to call from an interrupt
+// Inputs:  sensor  0 to TS_NUM_SENSORS-1
+//          value   12-bit reading
+// Outputs: none
+void TimeSeries_Put(uint32_t sensor, uint16_t value);
+
+//------------TimeSeries_Read------------
+// Copies the newest points of one resolution, oldest first, O(num)
+// Raw samples come back with min, mean and max all equal to the sample
+// Inputs:  sensor  0 to TS_NUM_SENSORS-1
+//          level   TS_RAW, TS_MINUTE or TS_HOUR
+//          num     largest number of points wanted
+//          points  buffer with room for num buckets
+// Outputs: number of points copied, less than num if the history is shorter
+uint32_t TimeSeries_Read(uint32_t sensor, uint32_t level, uint32_t num, TimeSeries_Bucket points[]);
+
+//------------TimeSeries_Latest------------
+// Inputs:  sensor  0 to TS_NUM_SENSORS-1
+// Outputs: most recent raw sample, 0 if none yet
+uint16_t TimeSeries_Latest(uint32_t sensor);
+
+#endif
@@ -0,0 +1,240 @@
+// ui.c
+// Runs on TM4C123
+// Retained-mode screen layer on top of the ST7735 driver.
+// The widgets on the LCD are remembered along with a signature of what
+// each one showed when it was drawn. A new screen is compared against
+// that list: a widget in the same place showing the same thing is kept,
+// one in the same place showing something else is painted over without
+// an erase, and anything left over is filled with black. Changing modes
+// therefore only touches the pixels that differ between the two screens.
+
+#include <stdint.h>
+#include "ui.h"
+#include "ST7735.h"
+#include "qformat.h"
+
+#define UI_LABEL        0
+#define UI_NUMBER       1
+#define UI_BITMAP       2
+#define UI_REGION       3
+
+#define CHAR_WIDTH      6      // font cell, as ST7735_DrawString
+#define CHAR_HEIGHT     10
+
+typedef struct
+{
+	uint8_t type;
+	uint8_t x, y, w, h;        // bounding rectangle in pixels
+	uint8_t decimals;          // UI_NUMBER only
+	uint8_t dirty;             // repaint on the next Ui_Refresh
+	uint16_t color;
+	const void *source;        // text, value, bitmap or region state
+	void (*draw)(void);        // UI_REGION only
+	uint32_t signature;        // contents when last drawn
+} Ui_Widget;
+
+Ui_Widget static Shown[UI_MAX_WIDGETS];      // what is on the LCD now
+uint32_t static NumShown = 0;
+Ui_Widget static Pending[UI_MAX_WIDGETS];    // screen being built
+uint32_t static NumPending = 0;
+
+// FNV-1a, only used to notice that something changed
+uint32_t static hashBytes(uint32_t hash, const uint8_t *bytes, uint32_t length)
+{
+	for(uint32_t i = 0; i < length; i++)
+	{
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+	return hash;
+}
+
+uint32_t static signature(const Ui_Widget *widget)
+{
+	uint32_t hash = 2166136261u;
+	switch(widget->type)
+	{
+		case UI_LABEL:
+		{
+			const char *text = widget->source;
+			uint32_t length = 0;
+			while(length < widget->w / CHAR_WIDTH && text[length]) {length++;}
+			return hashBytes(hash, (const uint8_t *)text, length);
+		}
+		case UI_NUMBER:
+			return hashBytes(hash, widget->source, sizeof(int32_t));
+		case UI_BITMAP:
+			return hashBytes(hash, (const uint8_t *)&widget->source, sizeof(widget->source));
+		default:
+			hash = hashBytes(hash, (const uint8_t *)&widget->draw, sizeof(widget->draw));
+			return hashBytes(hash, widget->source, sizeof(int32_t));
+	}
+}
+
+void static drawText(const Ui_Widget *widget, const char *text)
+{
+	char line[UI_MAX_CHARS + 1];
+	uint32_t width = widget->w / CHAR_WIDTH;
+	uint32_t i = 0;
+	for(; i < width && text[i]; i++) {line[i] = text[i];}
+	for(; i < width; i++) {line[i] = ' ';}		//pad so old, longer text is covered
+	line[width] = 0;
+	ST7735_DrawString(widget->x / CHAR_WIDTH, widget->y / CHAR_HEIGHT, line, widget->color);
+}
+
+//SSI0 traffic is charged to profile tag 1 + the widget id, see ST7735_PROFILE
+void static draw(const Ui_Widget *widget)
+{
+	ST7735_ProfileTag(1 + (widget - Shown));
+	switch(widget->type)
+	{
+		case UI_LABEL:
+			drawText(widget, widget->source);
+			break;
+		case UI_NUMBER:
+		{
+			char number[14];		//sign, 10 digits, point, null
+			number[Fmt_Fixed(number, *(const int32_t *)widget->source, widget->decimals)] = 0;
+			drawText(widget, number);
+			break;
+		}
+		case UI_BITMAP:
+			ST7735_DrawRLEBitmap(widget->x, widget->y + widget->h - 1, widget->source);
+			break;
+		default:
+			widget->draw();
+			break;
+	}
+	ST7735_ProfileTag(0);
+}
+
+int static sameRect(const Ui_Widget *a, const Ui_Widget *b)
+{
+	return a->type == b->type && a->x == b->x && a->y == b->y && a->w == b->w && a->h == b->h;
+}
+
+int static overlaps(const Ui_Widget *a, const Ui_Widget *b)
+{
+	return a->x < b->x + b->w && b->x < a->x + a->w && a->y < b->y + b->h && b->y < a->y + a->h;
+}
+
+int static add(uint8_t type, uint8_t x, uint8_t y, uint8_t w, uint8_t h, const void *source)
+{
+	if(NumPending >= UI_MAX_WIDGETS) {return -1;}
+	Ui_Widget *widget = &Pending[NumPending];
+	widget->type = type;
+	widget->x = x;
+	widget->y = y;
+	widget->w = w;
+	widget->h = h;
+	widget->decimals = 0;
+	widget->dirty = 1;
+	widget->color = ST7735_WHITE;
+	widget->source = source;
+	widget->draw = 0;
+	return NumPending++;
+}
+
+int static addText(uint8_t type, uint8_t col, uint8_t row, uint8_t width, const void *source, uint16_t color)
+{
+	if(col >= UI_MAX_CHARS) {return -1;}
+	if(width > UI_MAX_CHARS - col) {width = UI_MAX_CHARS - col;}
+	int id = add(type, col * CHAR_WIDTH, row * CHAR_HEIGHT, width * CHAR_WIDTH, CHAR_HEIGHT, source);
+	if(id >= 0) {Pending[id].color = color;}
+	return id;
+}
+
+void Ui_Begin(void)
+{
+	NumPending = 0;
+}
+
+int Ui_Label(uint8_t col, uint8_t row, uint8_t width, const char *text, uint16_t color)
+{
+	return addText(UI_LABEL, col, row, width, text, color);
+}
+
+int Ui_Number(uint8_t col, uint8_t row, uint8_t width, const int32_t *value, uint8_t decimals, uint16_t color)
+{
+	int id = addText(UI_NUMBER, col, row, width, value, color);
+	if(id >= 0) {Pending[id].decimals = decimals;}
+	return id;
+}
+
+int Ui_Bitmap(uint8_t x, uint8_t y, const RLEBitmap *bitmap)
+{
+	return add(UI_BITMAP, x, y - bitmap->height + 1, bitmap->width, bitmap->height, bitmap);
+}
+
+int Ui_Region(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const int32_t *state, void (*draw)(void))
+{
+	int id = add(UI_REGION, x, y, w, h, state);
+	if(id >= 0) {Pending[id].draw = draw;}
+	return id;
+}
+
+void Ui_End(void)
+{
+	uint8_t covered[UI_MAX_WIDGETS] = {0};		//old widgets painted over by a new one
+	for(uint32_t i = 0; i < NumPending; i++)
+	{
+		Ui_Widget *widget = &Pending[i];
+		widget->signature = signature(widget);
+		for(uint32_t j = 0; j < NumShown; j++)
+		{
+			if(!covered[j] && sameRect(widget, &Shown[j]))
+			{
+				covered[j] = 1;
+				widget->dirty = Shown[j].dirty || widget->color != Shown[j].color
+					|| widget->decimals != Shown[j].decimals || widget->signature != Shown[j].signature;
+				break;
+			}
+		}
+	}
+	for(uint32_t j = 0; j < NumShown; j++)
+	{
+		if(covered[j]) {continue;}
+		ST7735_FillRect(Shown[j].x, Shown[j].y, Shown[j].w, Shown[j].h, ST7735_BLACK);
+		for(uint32_t i = 0; i < NumPending; i++)
+		{
+			if(overlaps(&Pending[i], &Shown[j])) {Pending[i].dirty = 1;}
+		}
+	}
+	for(uint32_t i = 0; i < NumPending; i++)
+	{
+		Shown[i] = Pending[i];
+		if(Shown[i].dirty)
+		{
+			draw(&Shown[i]);
+			Shown[i].dirty = 0;
+		}
+	}
+	NumShown = NumPending;
+}
+
+uint32_t Ui_Refresh(void)
+{
+	uint32_t repainted = 0;
+	for(uint32_t i = 0; i < NumShown; i++)
+	{
+		uint32_t current = signature(&Shown[i]);
+		if(Shown[i].dirty || current != Shown[i].signature)
+		{
+			Shown[i].signature = current;
+			Shown[i].dirty = 0;
+			draw(&Shown[i]);
+			repainted++;
+		}
+	}
+	return repainted;
+}
+
+void Ui_Clear(void)
+{
+	ST7735_FillScreen(ST7735_BLACK);
+	NumShown = 0;
+}
+
+void Ui_Invalidate(int id)
+{
+	if(id >= 0 && (uint32_t)id < NumShown) {Shown[id].dirty = 1;}
+}
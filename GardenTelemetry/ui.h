@@ -0,0 +1,87 @@
+// ui.h
+// Runs on TM4C123
+// Retained-mode screen layer on top of the ST7735 driver.
+// A screen is a short list of widgets built between Ui_Begin and Ui_End.
+// Ui_End compares it with the screen already on the LCD and only repaints
+// widgets that differ, and Ui_Refresh repaints widgets whose contents
+// changed since they were last drawn. Widgets on one screen must not overlap.
+
+#ifndef UI_H
+#define UI_H
+
+#include <stdint.h>
+#include "ST7735.h"
+
+#define UI_MAX_WIDGETS  24     // the dashboard uses 22
+#define UI_MAX_CHARS    21     // characters across the screen
+
+//------------Ui_Begin------------
+// Starts building the next screen, nothing is drawn until Ui_End
+// Inputs:  none
+// Outputs: none
+void Ui_Begin(void);
+
+//------------Ui_Label------------
+// Adds a text label at a character cell, padded with spaces to width
+// Inputs:  col, row     character cell, as ST7735_DrawString
+//          width        characters reserved for the text
+//          text         null terminated string, read again by Ui_Refresh
+//          color        16-bit text color, background is black
+// Outputs: widget id, or -1 if the screen is full
+int Ui_Label(uint8_t col, uint8_t row, uint8_t width, const char *text, uint16_t color);
+
+//------------Ui_Number------------
+// Adds a fixed point number at a character cell, padded with spaces to width
+// Inputs:  col, row     character cell
+//          width        characters reserved for the number
+//          value        value to show, read again by Ui_Refresh
+//          decimals     digits after the decimal point, value is scaled by 10^decimals
+//          color        16-bit text color, background is black
+// Outputs: widget id, or -1 if the screen is full
+int Ui_Number(uint8_t col, uint8_t row, uint8_t width, const int32_t *value, uint8_t decimals, uint16_t color);
+
+//------------Ui_Bitmap------------
+// Adds an RLE bitmap
+// Inputs:  x, y         lower left corner, as ST7735_DrawRLEBitmap
+//          bitmap       image to draw
+// Outputs: widget id, or -1 if the screen is full
+int Ui_Bitmap(uint8_t x, uint8_t y, const RLEBitmap *bitmap);
+
+//------------Ui_Region------------
+// Adds a rectangle painted by a callback, redrawn whenever *state changes
+// The callback must paint the whole rectangle.
+// Inputs:  x, y         upper left corner
+//          w, h         size in pixels
+//          state        anything that changes when the region needs repainting
+//          draw         paints the region
+// Outputs: widget id, or -1 if the screen is full
+int Ui_Region(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const int32_t *state, void (*draw)(void));
+
+//------------Ui_End------------
+// Replaces the screen on the LCD with the one just built
+// Widgets already showing the same thing in the same place are left alone,
+// widgets that move or disappear are erased to black.
+// Inputs:  none
+// Outputs: none
+void Ui_End(void);
+
+//------------Ui_Refresh------------
+// Repaints the widgets on the current screen whose contents changed
+// Inputs:  none
+// Outputs: number of widgets repainted
+uint32_t Ui_Refresh(void);
+
+//------------Ui_Clear------------
+// Blanks the LCD and forgets the current screen, for use after
+// something outside this layer has drawn on the display
+// Inputs:  none
+// Outputs: none
+void Ui_Clear(void);
+
+//------------Ui_Invalidate------------
+// Forces a widget on the current screen to be repainted by the next Ui_Refresh
+// Inputs:  id           widget id from the screen currently showing
+// Outputs: none
+void Ui_Invalidate(int id);
+
+#endif
@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+# blynkframe.py
+# Host side of the binary frames in GardenTelemetry/frame.h: CRC16-CCITT
+# (0x1021, initial 0xFFFF, high byte first) after the payload, COBS
+# encoding and a zero delimiter. A payload is a varint virtual pin
+# followed by zig-zag varint values. A batch payload starts with
+# BATCH, then the pin, the sample interval in ms, a keyframe sample and
+# the difference of each later sample from the one before.
+#   python3 Tools/blynkframe.py decode capture.bin   prints pin,values per frame
+#   python3 Tools/blynkframe.py encode 20 300 500 400  prints the frame in hex
+#   python3 Tools/blynkframe.py bench trace.txt...     compression per virtual pin
+#
+# bench takes UART0 captures from esp8266replay.py, using the uplink
+# lines, or plain text with one "pin,value" line per sample. For each
+# virtual pin it prints the bytes needed as CSV lines, as one frame per
+# sample and as batches, and the seconds each takes at 9600 baud.
+import os
+import sys
+
+MAX_PAYLOAD = 64      # FRAME_MAX_PAYLOAD
+BATCH = 256           # FRAME_BATCH
+BAUD = 9600
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_at, code = 0, 1
+    for byte in data:
+        if byte:
+            out.append(byte)
+            code += 1
+        if byte == 0 or code == 0xFF:
+            out[code_at] = code
+            code_at, code = len(out), 1
+            out.append(0)
+    out[code_at] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def put_varint(value):
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def get_varint(data, i):
+    """Returns (value, next index), or None if data ends inside the varint."""
+    value = 0
+    for shift in range(0, 35, 7):
+        if i >= len(data):
+            return None
+        value |= (data[i] & 0x7F) << shift
+        i += 1
+        if not data[i - 1] & 0x80:
+            return value & 0xFFFFFFFF, i
+    return None
+
+
+def zigzag(value):
+    return ((value << 1) ^ (value >> 31)) & 0xFFFFFFFF
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def encode(pin, values):
+    """One frame, delimiter included."""
+    payload = put_varint(pin) + b"".join(put_varint(zigzag(v)) for v in values)
+    crc = crc16(payload)
+    return cobs_encode(payload + bytes([crc >> 8, crc & 0xFF])) + b"\x00"
+
+
+def decode(frame):
+    """Payload of one frame without its delimiter, or None if it is damaged."""
+    data = cobs_decode(frame)
+    if data is None or len(data) < 2:
+        return None
+    payload, crc = data[:-2], data[-2] << 8 | data[-1]
+    return payload if crc16(payload) == crc else None
+
+
+def put_batch(pin, interval_ms, values):
+    """Batch payloads for the samples, split like Frame_PutBatch."""
+    payloads = []
+    i = 0
+    while i < len(values):
+        payload = put_varint(BATCH) + put_varint(pin) + put_varint(interval_ms)
+        first = i
+        while i < len(values):
+            delta = values[i] if i == first else (values[i] - values[i - 1] + 2**31) % 2**32 - 2**31
+            field = put_varint(zigzag(delta))
+            if len(payload) + len(field) > MAX_PAYLOAD:
+                break
+            payload += field
+            i += 1
+        payloads.append(payload)
+    return payloads
+
+
+def encode_batch(pin, interval_ms, values):
+    """Frames for the samples, delimiters included."""
+    out = b""
+    for payload in put_batch(pin, interval_ms, values):
+        crc = crc16(payload)
+        out += cobs_encode(payload + bytes([crc >> 8, crc & 0xFF])) + b"\x00"
+    return out
+
+
+def decode_values(payload):
+    """(pin, [values], interval ms) from a payload, interval None unless it is a batch,
+    or None if the payload is malformed."""
+    fields = []
+    i = 0
+    while i < len(payload):
+        item = get_varint(payload, i)
+        if item is None:
+            return None
+        fields.append(item[0])
+        i = item[1]
+    if not fields:
+        return None
+    if fields[0] != BATCH:
+        return fields[0], [unzigzag(v) for v in fields[1:]], None
+    if len(fields) < 4:
+        return None
+    values = []
+    for v in fields[3:]:
+        value = unzigzag(v) if not values else (values[-1] + unzigzag(v) + 2**31) % 2**32 - 2**31
+        values.append(value)
+    return fields[1], values, fields[2]
+
+
+class Reader:
+    """Splits a byte stream into frames, yields decode_values() or None for a bad frame."""
+
+    def __init__(self):
+        self.buf = bytearray()
+
+    def feed(self, data):
+        for byte in data:
+            if byte:
+                self.buf.append(byte)
+                continue
+            if self.buf:
+                payload = decode(bytes(self.buf))
+                yield decode_values(payload) if payload is not None else None
+            self.buf = bytearray()
+
+
+def load_trace(path):
+    """{pin: [values]} from a capture or a plain pin,value file."""
+    sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+    import esp8266replay
+    records, _ = esp8266replay.load(path)
+    if records:
+        lines = [r[2].decode("latin-1") for r in records if r[0] == "T"]
+    else:
+        with open(path, encoding="latin-1") as f:
+            lines = f.readlines()
+    samples = {}
+    for line in lines:
+        fields = line.strip().split(",")
+        try:
+            pin, value = int(fields[0]), int(fields[1])
+        except (ValueError, IndexError):
+            continue
+        samples.setdefault(pin, []).append(value)
+    return samples
+
+
+def csv_line(pin, value):
+    return ("%d,%d,0.0\n" % (pin, value)).encode("ascii")   # as ESP8266_SendPin writes it
+
+
+def bench(paths, interval_ms):
+    print("trace,pin,samples,csv_bytes,frame_bytes,batch_bytes,csv_over_batch,csv_s,batch_s")
+    total = [0, 0, 0, 0]
+    for path in paths:
+        for pin, values in sorted(load_trace(path).items()):
+            sizes = [len(values),
+                     sum(len(csv_line(pin, v)) for v in values),
+                     sum(len(encode(pin, [v])) for v in values),
+                     len(encode_batch(pin, interval_ms, values))]
+            total = [a + b for a, b in zip(total, sizes)]
+            print("%s,%d,%d,%d,%d,%d,%.2f,%.1f,%.1f" % (os.path.basename(path), pin, sizes[0], sizes[1], sizes[2],
+                  sizes[3], sizes[1] / sizes[3], sizes[1] * 10.0 / BAUD, sizes[3] * 10.0 / BAUD))
+    if total[3]:
+        print("all,,%d,%d,%d,%d,%.2f,%.1f,%.1f" % (total[0], total[1], total[2], total[3], total[1] / total[3],
+              total[1] * 10.0 / BAUD, total[3] * 10.0 / BAUD))
+
+
+def main():
+    if len(sys.argv) >= 3 and sys.argv[1] == "encode":
+        print(encode(int(sys.argv[2]), [int(v) for v in sys.argv[3:]]).hex(" "))
+    elif len(sys.argv) == 3 and sys.argv[1] == "decode":
+        bad = 0
+        with open(sys.argv[2], "rb") as f:
+            for item in Reader().feed(f.read()):
+                if item is None:
+                    bad += 1
+                elif item[2] is None:
+                    print(",".join(str(v) for v in [item[0]] + item[1]))
+                else:
+                    print("batch,%d,%d,%s" % (item[0], item[2], ",".join(str(v) for v in item[1])))
+        print("bad frames: %d" % bad, file=sys.stderr)
+    elif len(sys.argv) >= 3 and sys.argv[1] == "bench":
+        bench(sys.argv[2:], 500)
+    else:
+        sys.exit("usage: blynkframe.py encode <pin> <value>... | decode <file> | bench <trace>...")
+
+
+if __name__ == "__main__":
+    main()
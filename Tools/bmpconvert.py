@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+# bmpconvert.py
+# Converts PNG artwork into the palette + run length encoded bitmap
+# format drawn by ST7735_DrawRLEBitmap, written as const C tables.
+#   python3 Tools/bmpconvert.py Tools/clock.png clock > GardenTelemetry/clockFace.h
+#
+# Format, rows stored top to bottom:
+#   palette  up to 16 RGB565 colors in the ST7735 bit order (see ST7735_Color565)
+#   data     one byte per run: low nibble palette index, high nibble run length-1
+#            a high nibble of 15 means a second byte follows holding
+#            extra length 0-255, so one run covers 1 to 271 pixels
+#            runs may continue from one row onto the next
+# Only 8-bit grey, RGB, RGBA and palette PNGs without interlace are read.
+import struct
+import sys
+import zlib
+
+MAX_COLORS = 16
+LONG_RUN = 16       # run length that needs the extension byte
+MAX_RUN = LONG_RUN + 255
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(path):
+    with open(path, "rb") as f:
+        raw = f.read()
+    if raw[:8] != b"\x89PNG\r\n\x1a\n":
+        sys.exit("%s: not a PNG file" % path)
+    pos, idat, plte = 8, b"", None
+    while pos < len(raw):
+        length, kind = struct.unpack(">I4s", raw[pos:pos + 8])
+        body = raw[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b"IHDR":
+            width, height, depth, ctype, _, _, interlace = struct.unpack(">IIBBBBB", body)
+        elif kind == b"PLTE":
+            plte = [tuple(body[i:i + 3]) for i in range(0, len(body), 3)]
+        elif kind == b"IDAT":
+            idat += body
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}.get(ctype)
+    if depth != 8 or interlace or channels is None:
+        sys.exit("%s: only 8-bit non-interlaced PNGs are supported" % path)
+    data = zlib.decompress(idat)
+    stride = width * channels
+    rows, prev, pos = [], bytearray(stride), 0
+    for _ in range(height):
+        kind, line = data[pos], bytearray(data[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        for i in range(stride):
+            left = line[i - channels] if i >= channels else 0
+            up, corner = prev[i], prev[i - channels] if i >= channels else 0
+            line[i] = (line[i] + (0, left, up, (left + up) // 2, paeth(left, up, corner))[kind]) & 0xFF
+        pixels = []
+        for x in range(width):
+            p = line[x * channels:(x + 1) * channels]
+            if ctype == 3:
+                pixels.append(plte[p[0]])
+            elif channels <= 2:
+                pixels.append((p[0], p[0], p[0]))
+            else:
+                pixels.append(tuple(p[:3]))
+        rows.append(pixels)
+        prev = line
+    return width, height, rows
+
+
+def color565(rgb):
+    r, g, b = rgb
+    return ((b & 0xF8) << 8) | ((g & 0xFC) << 3) | (r >> 3)
+
+
+def encode(width, height, rows):
+    palette, pixels = [], []
+    for row in rows:
+        for rgb in row:
+            color = color565(rgb)
+            if color not in palette:
+                palette.append(color)
+                if len(palette) > MAX_COLORS:
+                    sys.exit("more than %d colors after RGB565 conversion" % MAX_COLORS)
+            pixels.append(palette.index(color))
+    data, i = [], 0
+    while i < len(pixels):
+        run = 1
+        while i + run < len(pixels) and pixels[i + run] == pixels[i] and run < MAX_RUN:
+            run += 1
+        if run >= LONG_RUN:
+            data += [0xF0 | pixels[i], run - LONG_RUN]
+        else:
+            data.append(((run - 1) << 4) | pixels[i])
+        i += run
+    return palette, data
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: bmpconvert.py image.png name")
+    path, name = sys.argv[1], sys.argv[2]
+    width, height, rows = read_png(path)
+    palette, data = encode(width, height, rows)
+    out = sys.stdout
+    out.write("// Generated by Tools/bmpconvert.py from %s, do not edit by hand\n" % path.split("/")[-1])
+    out.write("// %dx%d, %d colors, %d bytes of runs (%d bytes as raw RGB565)\n\n"
+              % (width, height, len(palette), len(data), 2 * width * height))
+    out.write("const uint16_t %sPalette[%d] = {\n " % (name, len(palette)))
+    out.write(" ".join("0x%04X," % c for c in palette) + "\n};\n\n")
+    out.write("const uint8_t %sRuns[%d] = {\n" % (name, len(data)))
+    for i in range(0, len(data), 16):
+        out.write(" " + " ".join("0x%02X," % b for b in data[i:i + 16]) + "\n")
+    out.write("};\n\n")
+    out.write("const RLEBitmap %sBitmap = {%d, %d, %sPalette, %sRuns, %d};\n"
+              % (name, width, height, name, name, len(data)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+# esp8266replay.py
+# Summarizes and replays UART5 captures taken with ESP8266_CAPTURE
+# defined in esp8266.h.
+#   python3 Tools/esp8266replay.py stats capture.txt
+#   python3 Tools/esp8266replay.py replay capture.txt /dev/ttyUSB0 --speed 60
+#
+# A capture is the UART0 output of the firmware: "R <ms> <text>" for a
+# line received from the ESP8266, "T <ms> <text>" for a line sent to it
+# and "L <count>" when the firmware lost lines. Text is escaped with
+# \n \r \\ and \xHH. Other lines on the same port are skipped.
+#
+# replay stands in for the ESP8266: it writes the received lines to a
+# serial port wired to the board's UART5 (PE4/PE5), at their recorded
+# times divided by --speed, and compares the lines the board sends back
+# with the ones in the capture. Sensor values differ from run to run, so
+# uplink lines are compared by virtual pin, not by value. The board must
+# already be past ESP8266_SetupWiFi, which waits on the RDY pin.
+# Requires pyserial for replay.
+#
+# Tools/host/replay_uart5.c replays a capture into the firmware built
+# for a PC instead, faster than real time, and also checks the actuator
+# outputs.
+import argparse
+import re
+import sys
+import threading
+import time
+from collections import Counter
+
+RECORD = re.compile(r"^([RT]) (\d+) (.*)$")
+LOST = re.compile(r"^L (\d+)$")
+BAUD = 9600
+
+
+def unescape(text):
+    out = bytearray()
+    i = 0
+    while i < len(text):
+        c = text[i]
+        if c == "\\" and i + 1 < len(text):
+            nxt = text[i + 1]
+            if nxt == "x" and i + 3 < len(text):
+                out.append(int(text[i + 2:i + 4], 16))
+                i += 4
+                continue
+            out += {"n": b"\n", "r": b"\r", "\\": b"\\"}.get(nxt, nxt.encode("latin-1"))
+            i += 2
+            continue
+        out += c.encode("latin-1")
+        i += 1
+    return bytes(out)
+
+
+def load(path):
+    """Returns ([(direction, ms, bytes)], lines lost), records joined into whole lines."""
+    records, lost = [], 0
+    partial = {"R": None, "T": None}
+    source = sys.stdin if path == "-" else open(path, encoding="latin-1")
+    for line in source:
+        line = line.rstrip("\r\n")
+        m = RECORD.match(line)
+        if m:
+            direction, ms, data = m.group(1), int(m.group(2)), unescape(m.group(3))
+            if partial[direction] is not None:
+                ms, data = partial[direction][0], partial[direction][1] + data
+            if data.endswith(b"\n"):
+                records.append((direction, ms, data))
+                partial[direction] = None
+            else:
+                partial[direction] = (ms, data)
+            continue
+        m = LOST.match(line)
+        if m:
+            lost += int(m.group(1))
+    return records, lost
+
+
+def pin_of(data):
+    return data.split(b",", 1)[0].decode("latin-1", "replace").strip()
+
+
+def stats(args):
+    records, lost = load(args.capture)
+    if not records:
+        print("no records")
+        return 1
+    span = (records[-1][1] - records[0][1]) / 1000.0
+    print("duration_s,%.1f" % span)
+    print("lines_lost,%d" % lost)
+    for direction, name in (("R", "downlink"), ("T", "uplink")):
+        lines = [r for r in records if r[0] == direction]
+        size = sum(len(r[2]) for r in lines)
+        print("%s_lines,%d" % (name, len(lines)))
+        print("%s_bytes,%d" % (name, size))
+        if span > 0:
+            print("%s_bytes_per_s,%.1f" % (name, size / span))
+            print("%s_link_use_pct,%.1f" % (name, 100.0 * size * 10 / BAUD / span))
+        for pin, count in sorted(Counter(pin_of(r[2]) for r in lines).items()):
+            print("%s_pin_%s,%d" % (name, pin, count))
+    return 0
+
+
+def replay(args):
+    try:
+        import serial
+    except ImportError:
+        print("replay needs pyserial: pip install pyserial", file=sys.stderr)
+        return 2
+    records, _ = load(args.capture)
+    downlink = [r for r in records if r[0] == "R"]
+    expected = Counter(pin_of(r[2]) for r in records if r[0] == "T")
+    if not downlink:
+        print("no downlink lines to replay", file=sys.stderr)
+        return 1
+    port = serial.Serial(args.port, BAUD, timeout=0.1)
+    observed = Counter()
+    received = []
+    done = threading.Event()
+
+    def reader():
+        buf = b""
+        while not done.is_set():
+            buf += port.read(256)
+            while b"\n" in buf:
+                line, buf = buf.split(b"\n", 1)
+                received.append(line + b"\n")
+                observed[pin_of(line)] += 1
+    thread = threading.Thread(target=reader, daemon=True)
+    thread.start()
+
+    first = downlink[0][1]
+    start = time.monotonic()
+    sent = 0
+    for _, ms, data in downlink:
+        due = start + (ms - first) / 1000.0 / args.speed
+        delay = due - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+        port.write(data)
+        sent += len(data)
+    port.flush()
+    time.sleep(args.settle)
+    done.set()
+    thread.join()
+    elapsed = time.monotonic() - start
+
+    # with speed > 1 the board sends telemetry at its own rate, so scale the expectation
+    scale = (elapsed * 1000.0) / max(1, records[-1][1] - records[0][1])
+    print("replayed_lines,%d" % len(downlink))
+    print("replayed_bytes,%d" % sent)
+    print("elapsed_s,%.1f" % elapsed)
+    print("downlink_bytes_per_s,%.1f" % (sent / elapsed if elapsed else 0))
+    print("uplink_lines,%d" % len(received))
+    failures = 0
+    for pin in sorted(set(expected) | set(observed)):
+        want = expected[pin] * scale
+        got = observed[pin]
+        ok = abs(got - want) <= max(2, args.tolerance * want)
+        failures += 0 if ok else 1
+        print("uplink_pin_%s,%d,%.0f,%s" % (pin, got, want, "ok" if ok else "MISMATCH"))
+    return 1 if failures else 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Summarize or replay an ESP8266 UART5 capture")
+    sub = ap.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("stats", help="line counts, throughput and link use")
+    p.add_argument("capture", help="UART0 capture, - for stdin")
+    p = sub.add_parser("replay", help="play the downlink into the board")
+    p.add_argument("capture", help="UART0 capture, - for stdin")
+    p.add_argument("port", help="serial port wired to UART5")
+    p.add_argument("--speed", type=float, default=1.0, help="time compression, 1 plays in real time")
+    p.add_argument("--settle", type=float, default=2.0, help="seconds to keep listening after the last line")
+    p.add_argument("--tolerance", type=float, default=0.1, help="allowed relative error in uplink counts")
+    args = ap.parse_args()
+    if args.command == "stats":
+        return stats(args)
+    return replay(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,280 @@
+#!/usr/bin/env python3
+# esp8266standin.py
+# Plays the ESP8266 side of the CSV bridge in esp8266.c, so the board
+# can be exercised without the module or the Blynk cloud.
+#   python3 Tools/esp8266standin.py --port /dev/ttyUSB0 --script pins.txt
+#   python3 Tools/esp8266standin.py --pty --boot-ms 200 --script pins.txt
+#   Tools/host/link_uart5 <pty> <control>      (the names it prints)
+#
+# Handshake, as ESP8266_Reset and ESP8266_SetupWiFi expect it:
+#   1. RST (PE1) low resets the module. After --boot-ms the stand-in
+#      raises RDY (PE0).
+#   2. The board sends "auth,ssid,pass,\n".
+#   3. After --connect-ms the stand-in drops RDY and starts traffic.
+# With --port, RDY is driven on the adapter's RTS pin and RST is read
+# on its CTS pin, so wire RTS to PE0 and PE1 to CTS. RTS and CTS on USB
+# serial adapters are active low, and --invert-rdy flips RDY if the
+# adapter does not invert. Without a CTS wire the board's 5 s reset
+# pulse is missed, so the stand-in starts from step 1 at launch.
+# With --binary the stand-in answers a "cobs1" field after the password
+# with "cobs1,\n" before dropping RDY, and from then on both directions
+# use the frames in blynkframe.py (ESP8266_BINARY in esp8266.h).
+# With --pty two pseudo terminals are opened for another host program,
+# one for the UART5 bytes and a control line for the pins: the stand-in
+# writes "RDY 0" or "RDY 1" when it moves RDY and reads "RST 0" or
+# "RST 1" when the board moves RST. Tools/host/link_uart5.c runs the
+# firmware on the PC against them.
+#
+# Script lines are "<ms> <pin>,<int>,<float>": a virtual pin write sent
+# <ms> after the handshake; as a binary frame the float is left out. Lines starting with # are ignored. With
+# --repeat the script starts over after its last line.
+#
+# --latency, --jitter and --loss are applied to each line in both
+# directions. On exit (Ctrl-C or --duration) a CSV summary is printed:
+# traffic per direction, uplink lines and intervals per virtual pin, and
+# the time from each downlink write to the next uplink line.
+import argparse
+import heapq
+import os
+import random
+import select
+import sys
+import time
+import tty
+from collections import defaultdict
+
+import blynkframe
+
+BAUD = 9600
+
+
+class PtyLink:
+    def __init__(self):
+        self.master, slave = os.openpty()
+        self.control, control = os.openpty()
+        for fd in (slave, control):
+            tty.setraw(fd)
+        print("pty %s" % os.ttyname(slave), file=sys.stderr)
+        print("control %s" % os.ttyname(control), file=sys.stderr)
+        self.slave, self.control_slave = slave, control
+        self.control_rx = b""
+        self.reset = False
+
+    def read(self, timeout):
+        ready, _, _ = select.select([self.master], [], [], timeout)
+        return os.read(self.master, 256) if ready else b""
+
+    def write(self, data):
+        os.write(self.master, data)
+
+    def set_rdy(self, level):
+        os.write(self.control, b"RDY %d\n" % level)
+
+    def in_reset(self):
+        while select.select([self.control], [], [], 0)[0]:
+            self.control_rx += os.read(self.control, 256)
+        while b"\n" in self.control_rx:
+            line, self.control_rx = self.control_rx.split(b"\n", 1)
+            if line.startswith(b"RST "):
+                self.reset = line[4:].strip() == b"0"     # PE1 low holds the module in reset
+        return self.reset
+
+
+class SerialLink:
+    def __init__(self, port, invert_rdy):
+        try:
+            import serial
+        except ImportError:
+            sys.exit("--port needs pyserial: pip install pyserial")
+        self.port = serial.Serial(port, BAUD, timeout=0)
+        self.invert = invert_rdy
+
+    def read(self, timeout):
+        data = self.port.read(256)
+        if not data:
+            time.sleep(timeout)
+        return data
+
+    def write(self, data):
+        self.port.write(data)
+
+    def set_rdy(self, level):
+        self.port.rts = bool(level) == self.invert   # RTS asserted drives the pin low
+
+    def in_reset(self):
+        return self.port.cts                        # CTS asserted when PE1 is low
+
+
+def load_script(path):
+    steps = []
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            ms, _, message = line.partition(" ")
+            fields = message.split(",")
+            if len(fields) != 3:
+                sys.exit("%s:%d: expected <ms> <pin>,<int>,<float>" % (path, number))
+            steps.append((int(ms), message.encode("ascii") + b"\n", int(fields[0]), int(fields[1])))
+    return sorted(steps)
+
+
+class StandIn:
+    def __init__(self, link, args):
+        self.link = link
+        self.args = args
+        self.script = load_script(args.script) if args.script else []
+        self.queue = []          # (due, sequence, direction, bytes)
+        self.sequence = 0
+        self.rx = b""
+        self.stats = defaultdict(int)
+        self.pin_times = defaultdict(list)
+        self.pending_writes = []  # times of downlink writes waiting for an uplink line
+        self.response = []
+        self.frames = blynkframe.Reader()
+        self.boot()
+
+    def boot(self):
+        self.state = "boot"
+        self.state_time = time.monotonic()
+        self.link.set_rdy(0)
+        self.rx = b""
+        self.binary = False
+
+    def delay(self):
+        return max(0.0, (self.args.latency + random.uniform(-self.args.jitter, self.args.jitter)) / 1000.0)
+
+    def schedule(self, direction, data):
+        if random.random() < self.args.loss:
+            self.stats[direction + "_lost"] += 1
+            return
+        self.sequence += 1
+        heapq.heappush(self.queue, (time.monotonic() + self.delay(), self.sequence, direction, data))
+
+    def uplink(self, line, now):
+        self.stats["up_lines"] += 1
+        self.stats["up_bytes"] += len(line)
+        pin = line.split(b",", 1)[0].decode("latin-1", "replace")
+        self.pin_times[pin].append(now)
+        for sent in self.pending_writes:
+            self.response.append(now - sent)
+        self.pending_writes = []
+
+    def received(self, line, now):
+        if self.state == "credentials":
+            fields = line.rstrip(b"\n").split(b",")
+            if len(fields) >= 4 and fields[-1] == b"":
+                auth, ssid = fields[0].decode("latin-1"), fields[1].decode("latin-1")
+                print("credentials auth=%s... ssid=%s" % (auth[:6], ssid), file=sys.stderr)
+                if self.args.binary and b"cobs1" in fields[3:]:
+                    self.link.write(b"cobs1,\n")
+                    self.binary = True
+                self.state = "connecting"
+                self.state_time = now
+            else:
+                print("unexpected line during setup: %r" % line, file=sys.stderr)
+        elif self.state == "online":
+            self.uplink(line, now)
+
+    def step(self):
+        now = time.monotonic()
+        if self.link.in_reset():
+            if self.state != "boot":
+                print("reset", file=sys.stderr)
+            self.boot()
+            return
+        if self.state == "boot" and now - self.state_time >= self.args.boot_ms / 1000.0:
+            self.link.set_rdy(1)
+            self.state = "credentials"
+        elif self.state == "connecting" and now - self.state_time >= self.args.connect_ms / 1000.0:
+            self.link.set_rdy(0)
+            self.state = "online"
+            self.online = now
+            self.next_step = 0
+            print("online, %s" % ("binary frames" if self.binary else "CSV"), file=sys.stderr)
+        if self.state == "online" and self.script:
+            while self.next_step < len(self.script) and now - self.online >= self.script[self.next_step][0] / 1000.0:
+                _, line, pin, value = self.script[self.next_step]
+                self.schedule("down", blynkframe.encode(pin, [value]) if self.binary else line)
+                self.next_step += 1
+            if self.next_step == len(self.script) and self.args.repeat:
+                self.online += self.script[-1][0] / 1000.0
+                self.next_step = 0
+        while self.queue and self.queue[0][0] <= now:
+            _, _, direction, data = heapq.heappop(self.queue)
+            if direction == "down":
+                self.link.write(data)
+                self.stats["down_lines"] += 1
+                self.stats["down_bytes"] += len(data)
+                self.pending_writes.append(now)
+            else:
+                self.received(data, now)
+        data = self.link.read(0.005)
+        if self.binary:
+            for item in self.frames.feed(data):
+                if item is None:
+                    self.stats["up_bad_frames"] += 1
+                else:
+                    self.schedule("up", ",".join(str(v) for v in [item[0]] + item[1]).encode("ascii") + b"\n")
+            self.stats["up_frame_bytes"] += len(data)
+            return
+        self.rx += data
+        while b"\n" in self.rx:
+            line, self.rx = self.rx.split(b"\n", 1)
+            if self.state == "online":
+                self.schedule("up", line + b"\n")
+            else:
+                self.received(line + b"\n", now)
+
+    def report(self):
+        span = time.monotonic() - getattr(self, "online", time.monotonic())
+        print("online_s,%.1f" % span)
+        for key in ("down_lines", "down_bytes", "down_lost", "up_lines", "up_bytes", "up_lost",
+                    "up_frame_bytes", "up_bad_frames"):
+            print("%s,%d" % (key, self.stats[key]))
+        if span > 0:
+            print("down_bytes_per_s,%.1f" % (self.stats["down_bytes"] / span))
+            print("up_bytes_per_s,%.1f" % (self.stats["up_bytes"] / span))
+        for pin, times in sorted(self.pin_times.items()):
+            gaps = [b - a for a, b in zip(times, times[1:])]
+            mean = sum(gaps) / len(gaps) * 1000 if gaps else 0
+            print("up_pin_%s,%d,mean_ms=%.0f,max_ms=%.0f" % (pin, len(times), mean, max(gaps) * 1000 if gaps else 0))
+        if self.response:
+            ordered = sorted(self.response)
+            print("write_to_uplink_ms,mean=%.0f,p50=%.0f,max=%.0f" % (
+                sum(ordered) / len(ordered) * 1000, ordered[len(ordered) // 2] * 1000, ordered[-1] * 1000))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="ESP8266 stand-in for the CSV bridge on UART5")
+    where = ap.add_mutually_exclusive_group(required=True)
+    where.add_argument("--port", help="serial port wired to UART5, RDY and RST")
+    where.add_argument("--pty", action="store_true", help="open a pseudo terminal instead")
+    ap.add_argument("--invert-rdy", action="store_true", help="RTS is not inverted by the adapter")
+    ap.add_argument("--script", help="virtual pin writes, <ms> <pin>,<int>,<float> per line")
+    ap.add_argument("--repeat", action="store_true", help="loop the script")
+    ap.add_argument("--binary", action="store_true", help="accept the cobs1 offer and switch to binary frames")
+    ap.add_argument("--boot-ms", type=int, default=1000, help="reset released to RDY high")
+    ap.add_argument("--connect-ms", type=int, default=2000, help="credentials to RDY low")
+    ap.add_argument("--latency", type=float, default=0.0, help="ms added to each line")
+    ap.add_argument("--jitter", type=float, default=0.0, help="+/- ms of random latency")
+    ap.add_argument("--loss", type=float, default=0.0, help="fraction of lines dropped, 0 to 1")
+    ap.add_argument("--duration", type=float, default=0.0, help="seconds to run, 0 runs until Ctrl-C")
+    ap.add_argument("--seed", type=int, help="random seed for repeatable jitter and loss")
+    args = ap.parse_args()
+    random.seed(args.seed)
+
+    link = PtyLink() if args.pty else SerialLink(args.port, args.invert_rdy)
+    standin = StandIn(link, args)
+    start = time.monotonic()
+    try:
+        while not args.duration or time.monotonic() - start < args.duration:
+            standin.step()
+    except KeyboardInterrupt:
+        pass
+    standin.report()
+
+
+if __name__ == "__main__":
+    main()
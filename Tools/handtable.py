@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+# handtable.py
+# Generates GardenTelemetry/clockHands.h, the precomputed clock hand
+# endpoint tables used by clock.c.  Each entry is the (x,y) offset in
+# pixels from the clock center to the tip of the hand, rounded to the
+# nearest pixel.  y grows downward as it does on the ST7735.
+# The tables are static, so any file may include the header; each one
+# that does carries its own 1.5 KB copy, and only clock.c needs them.
+# Rerun whenever HOUR_HAND_SIZE or MINUTE_HAND_SIZE changes:
+#   python3 Tools/handtable.py > GardenTelemetry/clockHands.h
+import math
+import sys
+
+HOUR_HAND_SIZE = 17
+MINUTE_HAND_SIZE = 25
+MINUTE_POSITIONS = 60
+HOUR_POSITIONS = 720    # one position per minute over 12 hours
+
+
+def offsets(radius, positions):
+    table = []
+    for i in range(positions):
+        theta = 2.0 * math.pi * i / positions
+        table.append((int(round(radius * math.sin(theta))),
+                      int(round(-radius * math.cos(theta)))))
+    return table
+
+
+def emit(out, name, table, comment):
+    out.write("// %s\n" % comment)
+    out.write("static const int8_t %s[%d][2] = {\n" % (name, len(table)))
+    for row in range(0, len(table), 8):
+        chunk = table[row:row + 8]
+        out.write(" " + " ".join("{%3d,%3d}," % p for p in chunk) + "\n")
+    out.write("};\n\n")
+
+
+def main(out):
+    out.write("// clockHands.h\n")
+    out.write("// Generated by Tools/handtable.py, do not edit by hand\n")
+    out.write("// (x,y) offsets from the clock center to the tip of each hand\n\n")
+    out.write("#ifndef CLOCKHANDS_H\n#define CLOCKHANDS_H\n\n")
+    out.write("#include <stdint.h>\n\n")
+    out.write("#define HOUR_HAND_SIZE      %d\n" % HOUR_HAND_SIZE)
+    out.write("#define MINUTE_HAND_SIZE    %d\n" % MINUTE_HAND_SIZE)
+    out.write("#define MINUTE_POSITIONS    %d\n" % MINUTE_POSITIONS)
+    out.write("#define HOUR_POSITIONS      %d\n\n" % HOUR_POSITIONS)
+    emit(out, "MinuteHand", offsets(MINUTE_HAND_SIZE, MINUTE_POSITIONS),
+         "index is the minute, 0 to 59")
+    emit(out, "HourHand", offsets(HOUR_HAND_SIZE, HOUR_POSITIONS),
+         "index is (hour%12)*60 + minute, 0 to 719")
+    out.write("#endif\n")
+
+
+if __name__ == "__main__":
+    main(sys.stdout)
@@ -0,0 +1,79 @@
+// fuzz_uart5.c
+// Fuzz harness for the receive path from the ESP8266: UART5_Handler
+// copying out of the hardware FIFO, Rx5Fifo_Put and the binary frame
+// decoder, ESP8266_GetMessage, and the Blynk_to_TM4C parser with every
+// virtual pin it acts on. Each input is what the ESP8266 sends, with the
+// error escapes of uart5host.h, and is played once as CSV and once as
+// binary frames. A run that stops making progress aborts.
+// With clang and libFuzzer, from GardenTelemetry:
+//   clang -g -O1 -fsanitize=fuzzer,address,undefined -DESP8266_BINARY -Dmain=firmware_main -I.. -I../Tools/host -o fuzz_uart5 ../Tools/host/fuzz_uart5.c ../Tools/host/host.c Blynk.c frame.c qformat.c clock.c ui.c fixed.c ST7735.c histogram.c dashboard.c timeseries.c events.c stats.c PWM.c Timer.c UART.c ADCSWTrigger.c PortF.c PLL.c SysTick.c
+//   ./fuzz_uart5 -dict=../Tools/fuzz/blynk.dict fuzzcorpus ../Tools/fuzz/corpus
+// With gcc, add -DFUZZ_MAIN and use -fsanitize=address,undefined, then
+// ./fuzz_uart5 ../Tools/fuzz/corpus/* runs each file once.
+
+#undef main                  // -Dmain=firmware_main is for Blynk.c
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "uart5host.h"
+#include "GardenTelemetry/esp8266.c"
+
+void Blynk_to_TM4C(void);
+
+int static Started = 0;
+
+void static reset(uint32_t binary)
+{
+	Rx5Fifo_Init();
+#ifdef ESP8266_BINARY
+	FrameInLength = FrameInBad = 0;
+	BinaryMode = binary;
+#else
+	(void)binary;
+#endif
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	if(!Started)
+	{
+		Host_Init();
+		Started = 1;
+	}
+	for(uint32_t binary = 0; binary < 2; binary++)
+	{
+		uint32_t passes = 0;
+		reset(binary);
+		Uart5Host_Receive(data, size);
+		while(Uart5Host_Refill() || ESP8266_AvailableInput())
+		{
+			UART5_RIS_R = UART_RIS_RXRIS;
+			UART5_Handler();
+			Blynk_to_TM4C();     // one message, and what the FIFO still holds
+			passes++;
+			if(passes > 2*size + 16) {abort();}   // every pass takes a character or a message
+		}
+	}
+	return 0;
+}
+
+#ifdef FUZZ_MAIN
+int main(int argc, char **argv)
+{
+	static uint8_t input[1 << 16];
+	for(int i = 1; i < argc; i++)
+	{
+		FILE *f = fopen(argv[i], "rb");
+		if(f == NULL)
+		{
+			perror(argv[i]);
+			return 1;
+		}
+		size_t size = fread(input, 1, sizeof(input), f);
+		fclose(f);
+		LLVMFuzzerTestOneInput(input, size);
+		printf("%s: %u bytes\n", argv[i], (unsigned)size);
+	}
+	return 0;
+}
+#endif
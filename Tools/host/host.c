@@ -0,0 +1,128 @@
+// host.c
+// PC side of host.h, see there
+
+#define _GNU_SOURCE             // MAP_FIXED_NOREPLACE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include "host.h"
+#include "inc/tm4c123gh6pm.h"
+
+#define PERIPHERAL_BASE 0x40000000
+#define PERIPHERAL_SIZE 0x00100000
+#define PRIVATE_BASE    0xE0000000   // NVIC, SysTick and the debug units
+#define PRIVATE_SIZE    0x0000F000
+
+int static Enabled = 1;
+int static Started = 0;                 // SIGALRM is the interrupt
+int static InTick = 0;
+void static (*Tick)(void);
+sigset_t static Alarm;
+
+void Host_Init(void)
+{
+	void *window = mmap((void *)PERIPHERAL_BASE, PERIPHERAL_SIZE, PROT_READ | PROT_WRITE,
+	                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	if(window != (void *)PERIPHERAL_BASE)
+	{
+		fprintf(stderr, "host: cannot map the peripheral window at 0x%08X\n", PERIPHERAL_BASE);
+		exit(2);
+	}
+	SYSCTL_PRGPIO_R = 0x3F;		//every port, UART, SSI and timer reports its clock as ready
+	SYSCTL_PRUART_R = 0xFF;
+	SYSCTL_PRSSI_R = 0x0F;
+	SYSCTL_PRTIMER_R = 0x3F;
+}
+
+int Host_MapPrivate(void)
+{
+	void *window = mmap((void *)PRIVATE_BASE, PRIVATE_SIZE, PROT_READ | PROT_WRITE,
+	                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	return window == (void *)PRIVATE_BASE;
+}
+
+// the signal is blocked while this runs, as the I bit is set in a handler
+void static alarmHandler(int signal)
+{
+	(void)signal;
+	if(InTick) {return;}		//a handler enabled interrupts, the next alarm catches up
+	int enabled = Enabled;
+	InTick = 1;
+	Enabled = 0;
+	Tick();
+	Enabled = enabled;
+	InTick = 0;
+}
+
+void Host_StartInterrupts(void (*tick)(void))
+{
+	struct sigaction action = {0};
+	struct itimerval period = {{0, 1000}, {0, 1000}};
+	Tick = tick;
+	sigemptyset(&Alarm);
+	sigaddset(&Alarm, SIGALRM);
+	action.sa_handler = alarmHandler;
+	action.sa_flags = SA_RESTART;
+	sigaction(SIGALRM, &action, 0);
+	Started = 1;
+	sigprocmask(Enabled ? SIG_UNBLOCK : SIG_BLOCK, &Alarm, 0);
+	setitimer(ITIMER_REAL, &period, 0);
+}
+
+void static mask(void)
+{
+	if(Started) {sigprocmask(Enabled ? SIG_UNBLOCK : SIG_BLOCK, &Alarm, 0);}
+}
+
+int Host_InterruptsEnabled(void)
+{
+	return Enabled;
+}
+
+void DisableInterrupts(void)
+{
+	Enabled = 0;
+	mask();
+}
+
+void EnableInterrupts(void)
+{
+	Enabled = 1;
+	mask();
+}
+
+long StartCritical(void)
+{
+	long sr = !Enabled;		//the I bit, set when interrupts are masked
+	Enabled = 0;
+	mask();
+	return sr;
+}
+
+void EndCritical(long sr)
+{
+	Enabled = !sr;
+	mask();
+}
+
+// a pending alarm ends the wait even while it is masked, as on the board
+void WaitForInterrupt(void)
+{
+	sigset_t pending;
+	int caught;
+	if(!Started || InTick) {return;}
+	sigpending(&pending);
+	if(sigismember(&pending, SIGALRM)) {return;}
+	if(Enabled)
+	{
+		sigset_t open;
+		sigprocmask(SIG_BLOCK, 0, &open);
+		sigdelset(&open, SIGALRM);
+		sigsuspend(&open);
+		return;
+	}
+	sigwait(&Alarm, &caught);
+	raise(SIGALRM);		//still pending, it runs when the firmware unmasks
+}
@@ -0,0 +1,51 @@
+// host.h
+// Lets firmware sources from GardenTelemetry build and run on a PC for
+// the tests and harnesses in this directory. The TM4C123 peripheral
+// window 0x40000000 to 0x400FFFFF is mapped as plain memory, so register
+// writes land somewhere harmless and a register reads back what was last
+// written to it, except that the peripheral ready registers always read
+// as ready. A harness that needs a register to behave, such as a
+// UART flag register, redefines it before including the source it tests.
+// The interrupt mask functions from startup.s only keep the I bit here,
+// unless a harness starts interrupts with Host_StartInterrupts.
+
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdint.h>
+
+//------------Host_Init------------
+// Maps the peripheral window, call before any firmware code runs
+// Inputs:  none
+// Outputs: none, exits if the window cannot be mapped
+void Host_Init(void);
+
+//------------Host_MapPrivate------------
+// Maps the NVIC, SysTick and debug registers at 0xE000E000 as plain
+// memory too, for a harness that runs the firmware's init code. Fails
+// under -fsanitize=address, which keeps that range for itself.
+// Inputs:  none
+// Outputs: 1 if the range is mapped
+int Host_MapPrivate(void);
+
+//------------Host_StartInterrupts------------
+// Calls tick every millisecond from SIGALRM, as an interrupt: it stops
+// the firmware wherever interrupts are enabled and waits while they are
+// masked, and WaitForInterrupt returns after it. tick finds the handlers
+// that are due and calls them, with interrupts masked.
+// Inputs:  tick  the interrupt controller of the harness
+// Outputs: none
+void Host_StartInterrupts(void (*tick)(void));
+
+//------------Host_InterruptsEnabled------------
+// Inputs:  none
+// Outputs: 1 if the firmware last left interrupts enabled
+int Host_InterruptsEnabled(void);
+
+void DisableInterrupts(void);
+void EnableInterrupts(void);
+long StartCritical(void);
+void EndCritical(long sr);
+void WaitForInterrupt(void);
+
+#endif
@@ -0,0 +1,80 @@
+// hostbench.c
+// Runs the microbenchmarks of GardenTelemetry/bench.c on a PC and prints
+// the same CSV the board prints on UART0. The DWT cycle counter is
+// replaced by the host clock, so cycles_per_op is nanoseconds per op on
+// the PC: good for comparing two builds of the same code, not for board
+// timings. The byte columns are exact. Add -DST7735_PROFILE for the LCD
+// column.
+//   cd GardenTelemetry
+//   gcc -std=gnu99 -O2 -Dmain=firmware_main -I.. -I../Tools/host -o hostbench ../Tools/host/hostbench.c ../Tools/host/host.c Blynk.c frame.c qformat.c clock.c ui.c fixed.c histogram.c dashboard.c timeseries.c events.c stats.c PWM.c Timer.c ADCSWTrigger.c PortF.c PLL.c SysTick.c
+//   ./hostbench
+
+#undef main                  // -Dmain=firmware_main is for Blynk.c
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "host.h"
+#include "inc/tm4c123gh6pm.h"
+
+// the NVIC, SysTick and DWT are outside the window host.c can map, writes
+// to them go nowhere and the cycle counter is the host clock
+uint32_t volatile static HostPrivate;
+uint32_t volatile static HostCycles;
+
+uint32_t volatile static *hostCycles(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	HostCycles = (uint32_t)((uint64_t)now.tv_sec*1000000000u + now.tv_nsec);
+	return &HostCycles;
+}
+
+#undef NVIC_EN1_R
+#undef NVIC_DIS1_R
+#undef NVIC_ST_CTRL_R
+#undef NVIC_ST_CURRENT_R
+#undef NVIC_ST_RELOAD_R
+#define NVIC_EN1_R   HostPrivate
+#define NVIC_DIS1_R  HostPrivate
+#define NVIC_ST_CTRL_R    HostPrivate   // SysTick reads as stopped, so the
+#define NVIC_ST_CURRENT_R HostPrivate   // profile counts no SSI0 waits
+#define NVIC_ST_RELOAD_R  HostPrivate
+#define DEMCR_R      HostPrivate
+#define DEMCR_TRCENA 0
+#define DWT_CTRL_R   HostPrivate
+#define DWT_CYCCNTENA 0
+#define DWT_CYCCNT_R (*hostCycles())
+
+#include "uart5host.h"
+#include "GardenTelemetry/esp8266.c"
+#include "GardenTelemetry/ST7735.c"
+#include "GardenTelemetry/bench.c"
+
+// UART0 is stdout, UART.c is not built here
+uint32_t static HostUartBytes = 0;
+void UART_Init(uint32_t priority) {(void)priority;}
+void UART_OutChar(char data) {HostUartBytes++; putchar(data);}
+void UART_OutCharPolled(char data) {UART_OutChar(data);}
+uint32_t UART_OutCount(void) {return HostUartBytes;}
+void UART_OutString(char *pt) {while(*pt) {UART_OutChar(*pt++);}}
+void UART_OutUDec(uint32_t n)
+{
+	if(n >= 10) {UART_OutUDec(n/10);}
+	UART_OutChar('0' + n%10);
+}
+void UART_OutUHex(uint32_t number)
+{
+	if(number >= 16) {UART_OutUHex(number/16);}
+	UART_OutChar("0123456789ABCDEF"[number%16]);
+}
+
+int main(void)
+{
+	Host_Init();
+	SSI0_SR_R = SSI_SR_TNF;		//transmit FIFO never full, never busy
+	ST7735_InitR(INITR_REDTAB);
+	Rx5Fifo_Init();
+	Tx5Fifo_Init();
+	Bench_Run();
+	return 0;
+}
@@ -0,0 +1,88 @@
+// lcdtrace.c
+// Runs the drawing code of GardenTelemetry on a PC with ST7735_TRACE
+// defined and prints the SSI0 trace the panel would receive, the same
+// text the board prints on UART0, for Tools/st7735emu.py. The golden
+// traces in Tools/golden were made with it, so rerun it when a change
+// to the drawing code is meant to change the screen.
+//   cd GardenTelemetry
+//   gcc -std=c99 -DST7735_TRACE -I.. -I../Tools/host -o lcdtrace ../Tools/host/lcdtrace.c ../Tools/host/host.c clock.c ui.c fixed.c ST7735.c histogram.c qformat.c dashboard.c timeseries.c events.c
+//   ./lcdtrace clock | gzip -n > ../Tools/golden/clock.trace.gz
+// Scenarios are clock, graph and text. Each starts with ST7735_InitR and
+// marks a frame after every screen update.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "host.h"
+#include "inc/tm4c123gh6pm.h"
+#include "GardenTelemetry/ST7735.h"
+#include "GardenTelemetry/clock.h"
+#include "GardenTelemetry/Timer.h"
+#include "GardenTelemetry/PWM.h"
+#include "GardenTelemetry/esp8266.h"
+#include "GardenTelemetry/UART.h"
+
+// what the firmware gets from modules that are not built here
+void UART_OutCharPolled(char data) {putchar(data);}
+void Timer0_Init(void(*task)(void), uint32_t period) {(void)task; (void)period;}
+void PWM0A_Init(uint16_t period, uint16_t duty) {(void)period; (void)duty;}
+uint32_t ESP8266_MessageCount(void) {return 0;}
+uint32_t ESP8266_OutputQueueSize(void) {return 0;}
+
+// the clock screen at its start up time, then after the app sets the time
+void static clockScenario(void)
+{
+	clockMode();
+	ST7735_TraceFrame();
+	setTimeOfDay(22, 10, 5);
+	clockMode();
+	ST7735_TraceFrame();
+}
+
+// one histogram frame of 20 readings
+void static graphScenario(void)
+{
+	static const int readings[] = {5, 12, 12, 20, 33, 33, 33, 40, 41, 64,
+	                               64, 64, 64, 70, 90, 100, 100, 110, 127, 12};
+	initSensorGraph();
+	clockMode();
+	setMode(GRAPH_SENSORS_MODE);
+	graphSensorsMode();
+	ST7735_TraceFrame();
+	for(uint32_t i = 0; i < sizeof(readings) / sizeof(readings[0]); i++) {putData(readings[i]);}
+	graphSensorsMode();
+	ST7735_TraceFrame();
+}
+
+void static textScenario(void)
+{
+	ST7735_FillScreen(ST7735_BLACK);
+	ST7735_DrawString(0, 0, "Garden Telemetry", ST7735_YELLOW);
+	ST7735_DrawString(0, 2, "0123456789 !?.,:;", ST7735_WHITE);
+	ST7735_DrawString(0, 3, "ABCDEFGHIJKLMNOPQRSTU", ST7735_GREEN);
+	ST7735_DrawString(0, 4, "abcdefghijklmnopqrstu", ST7735_CYAN);
+	ST7735_DrawString(15, 15, "right", ST7735_MAGENTA);
+	ST7735_DrawCharS(8, 60, 'G', ST7735_RED, ST7735_BLACK, 3);
+	ST7735_DrawChar(40, 60, 'T', ST7735_BLUE, ST7735_WHITE, 2);
+	ST7735_SetCursor(0, 12);
+	ST7735_OutString("OutString, row 12");
+	ST7735_TraceFrame();
+}
+
+int main(int argc, char **argv)
+{
+	const char *scenario = (argc == 2) ? argv[1] : "";
+	Host_Init();
+	SSI0_SR_R = SSI_SR_TNF;		//transmit FIFO never full, never busy
+	ST7735_InitR(INITR_REDTAB);
+	if(strcmp(scenario, "clock") == 0) {clockScenario();}
+	else if(strcmp(scenario, "graph") == 0) {graphScenario();}
+	else if(strcmp(scenario, "text") == 0) {textScenario();}
+	else
+	{
+		fprintf(stderr, "usage: lcdtrace clock|graph|text\n");
+		return 1;
+	}
+	putchar('\n');
+	return 0;
+}
@@ -0,0 +1,249 @@
+// link_uart5.c
+// Runs the whole firmware on a PC, main() and all, against
+// Tools/esp8266standin.py --pty, so the stand-in's latency and rate
+// numbers can be taken without a board. UART5 is the stand-in's data
+// pty at 9600 baud in both directions: received bytes go through
+// Uart5Host_Receive and UART5_Handler, and the transmit tiers are
+// drained onto the pty as copySoftwareToHardware5 would drain them.
+// RDY (PE0) and RST (PE1) are the stand-in's control pty, "RDY n" lines
+// in and "RST n" lines out. Timer0, 2 and 3 and SysTick interrupt at the
+// periods the firmware loads, from the 1 ms alarm of host.h, and UART0
+// goes to stdout.
+// DelayMs is a busy loop tuned for 80 MHz, so ESP8266_Reset's pulse and
+// the waits in ESP8266_SetupWiFi are shorter here; the stand-in sees
+// every RST edge but --boot-ms must stay under a few hundred ms. Port F
+// reads as a master board.
+// The NVIC and SysTick have to be mapped, so build without
+// -fsanitize=address. From GardenTelemetry:
+//   gcc -std=gnu99 -O1 -g -fsanitize=undefined -Dmain=firmware_main -I.. -I../Tools/host -o link_uart5 ../Tools/host/link_uart5.c ../Tools/host/host.c Blynk.c frame.c qformat.c clock.c ui.c fixed.c ST7735.c histogram.c dashboard.c timeseries.c events.c stats.c PWM.c Timer.c ADCSWTrigger.c PortF.c PLL.c SysTick.c
+//   python3 ../Tools/esp8266standin.py --pty --boot-ms 200 --script pins.txt
+//   ./link_uart5 <pty> <control> [seconds]
+
+#undef main                  // -Dmain=firmware_main is for Blynk.c
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "uart5host.h"
+#include "GardenTelemetry/esp8266.c"
+
+#define BUS_HZ       80000000
+#define CHAR_CYCLES  (BUS_HZ / 960)    // 10 bits at 9600 baud
+#define RDY_PIN      (*((volatile uint32_t *)0x40024004))
+#define RST_PIN      (*((volatile uint32_t *)0x40024008))
+
+int firmware_main(void);
+void Timer0A_Handler(void);
+void Timer1A_Handler(void);
+void Timer2A_Handler(void);
+void Timer3A_Handler(void);
+void SysTick_Handler(void);
+
+int static Data, Control;               // the stand-in's ptys
+uint64_t static Start, Last;            // bus cycles
+uint64_t static Stop = 0;               // 0 runs until killed
+uint8_t static RxIn[1024], RxOut[1024]; // read from the pty, being received
+uint32_t static RxInLength = 0;
+uint64_t static RxCycles = 0, TxCycles = 0;
+uint8_t static ControlLine[32];
+uint32_t static ControlLength = 0;
+int static ResetLevel = -1;
+
+// UART0 is stdout, UART.c is not built here. write() because the
+// handlers print too and may stop the main loop in the middle of a line.
+uint32_t static HostUartBytes = 0;
+void UART_Init(uint32_t priority) {(void)priority;}
+void UART_OutChar(char data) {HostUartBytes++; if(write(1, &data, 1)) {}}
+void UART_OutCharPolled(char data) {UART_OutChar(data);}
+uint32_t UART_OutCount(void) {return HostUartBytes;}
+void UART_OutString(char *pt) {while(*pt) {UART_OutChar(*pt++);}}
+void UART_OutUDec(uint32_t n)
+{
+	if(n >= 10) {UART_OutUDec(n/10);}
+	UART_OutChar('0' + n%10);
+}
+void UART_OutUHex(uint32_t number)
+{
+	if(number >= 16) {UART_OutUHex(number/16);}
+	UART_OutChar("0123456789ABCDEF"[number%16]);
+}
+
+uint64_t static cycles(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec*BUS_HZ + (uint64_t)now.tv_nsec*(BUS_HZ/1000000)/1000;
+}
+
+int static openRaw(const char *path)
+{
+	struct termios raw;
+	int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if(fd < 0) {perror(path); exit(2);}
+	if(tcgetattr(fd, &raw) == 0)
+	{
+		cfmakeraw(&raw);
+		tcsetattr(fd, TCSANOW, &raw);
+	}
+	return fd;
+}
+
+// "RDY n" from the stand-in sets PE0, PE1 changes go back as "RST n"
+void static pins(void)
+{
+	uint8_t c;
+	while(read(Control, &c, 1) == 1)
+	{
+		if(c != '\n')
+		{
+			if(ControlLength < sizeof(ControlLine) - 1) {ControlLine[ControlLength++] = c;}
+			continue;
+		}
+		ControlLine[ControlLength] = 0;
+		if(strncmp((char *)ControlLine, "RDY ", 4) == 0) {RDY_PIN = (ControlLine[4] == '1') ? RDY1 : 0;}
+		ControlLength = 0;
+	}
+	int level = (RST_PIN & RST1) != 0;
+	if(level != ResetLevel)
+	{
+		char line[8];
+		ResetLevel = level;
+		snprintf(line, sizeof(line), "RST %d\n", level);
+		if(write(Control, line, strlen(line))) {}
+	}
+}
+
+// a FIFO's worth of the pty every 16 character times, then the UART5 interrupt
+void static receive(uint64_t elapsed)
+{
+	ssize_t n = read(Data, &RxIn[RxInLength], sizeof(RxIn) - RxInLength);
+	if(n > 0) {RxInLength += n;}
+	if((Uart5HostLeft == 0) && (RxInLength > 0))
+	{
+		uint32_t i, length = 0;
+		for(i = 0; (i < RxInLength) && (length + 3 <= sizeof(RxOut)); i++)
+		{
+			RxOut[length++] = RxIn[i];
+			if(RxIn[i] == UART5_HOST_ESCAPE) {RxOut[length++] = 0; RxOut[length++] = UART5_HOST_ESCAPE;}   // plain data
+		}
+		memmove(RxIn, &RxIn[i], RxInLength - i);
+		RxInLength -= i;
+		Uart5Host_Receive(RxOut, length);
+		RxCycles = 0;
+	}
+	if(Uart5HostLeft == 0) {return;}
+	RxCycles += elapsed;
+	if(RxCycles < UART5_HOST_FIFO*CHAR_CYCLES) {return;}
+	RxCycles -= UART5_HOST_FIFO*CHAR_CYCLES;
+	Uart5Host_Refill();
+	UART5_RIS_R = UART_RIS_RXRIS;
+	UART5_Handler();
+}
+
+// the tiers onto the pty at 9600 baud, a whole message at a time
+void static transmit(uint64_t elapsed)
+{
+	uint8_t out[64];
+	uint32_t length = 0;
+	TxCycles += elapsed;
+	while((TxCycles >= CHAR_CYCLES) && (length < sizeof(out)))
+	{
+		if(Tx5Left == 0)
+		{
+			if(tx5NextMessage() == FIFOFAIL) {break;}
+			continue;
+		}
+		out[length++] = Tx5Current[Tx5CurrentI++];
+		Tx5Left--;
+		Tx5Bytes[Tx5Tier]++;
+		TxCycles -= CHAR_CYCLES;
+	}
+	if(length && write(Data, out, length)) {}
+	if(TxCycles > UART5_HOST_FIFO*CHAR_CYCLES) {TxCycles = UART5_HOST_FIFO*CHAR_CYCLES;}   // the line was idle
+}
+
+typedef struct {
+	volatile uint32_t *ctl, *imr, *tailr;
+	void (*handler)(void);
+	uint64_t count;
+} HostTimer;
+
+HostTimer static Timers[] = {
+	{&TIMER0_CTL_R, &TIMER0_IMR_R, &TIMER0_TAILR_R, Timer0A_Handler, 0},
+	{&TIMER1_CTL_R, &TIMER1_IMR_R, &TIMER1_TAILR_R, Timer1A_Handler, 0},
+	{&TIMER2_CTL_R, &TIMER2_IMR_R, &TIMER2_TAILR_R, Timer2A_Handler, 0},
+	{&TIMER3_CTL_R, &TIMER3_IMR_R, &TIMER3_TAILR_R, Timer3A_Handler, 0},
+};
+uint64_t static SysTickCount = 0;
+
+// the handler once per period that passed, at most two periods behind
+void static timer(HostTimer *t, uint64_t elapsed)
+{
+	uint64_t period = (uint64_t)*t->tailr + 1;
+	if(((*t->ctl & 1) == 0) || ((*t->imr & 1) == 0)) {t->count = 0; return;}
+	t->count += elapsed;
+	if(t->count >= 2*period) {t->count = 2*period;}
+	while(t->count >= period)
+	{
+		t->count -= period;
+		t->handler();
+	}
+}
+
+// SysTick counts down from RELOAD, Event_WaitFrame reads CURRENT
+void static sysTick(uint64_t elapsed)
+{
+	uint64_t period = (NVIC_ST_RELOAD_R & 0x00FFFFFF) + 1;
+	if((NVIC_ST_CTRL_R & NVIC_ST_CTRL_ENABLE) == 0) {return;}
+	SysTickCount += elapsed;
+	if(SysTickCount >= period)
+	{
+		SysTickCount %= period;
+		if(NVIC_ST_CTRL_R & NVIC_ST_CTRL_INTEN) {SysTick_Handler();}
+	}
+	NVIC_ST_CURRENT_R = period - 1 - SysTickCount;
+}
+
+void static tick(void)
+{
+	uint64_t now = cycles();
+	uint64_t elapsed = now - Last;
+	uint32_t i;
+	Last = now;
+	if(Stop && (now - Start >= Stop)) {_exit(0);}
+	pins();
+	receive(elapsed);
+	transmit(elapsed);
+	for(i = 0; i < sizeof(Timers)/sizeof(Timers[0]); i++) {timer(&Timers[i], elapsed);}
+	sysTick(elapsed);
+}
+
+int main(int argc, char **argv)
+{
+	if(argc < 3)
+	{
+		fprintf(stderr, "usage: link_uart5 <pty> <control> [seconds]\n");
+		return 2;
+	}
+	Data = openRaw(argv[1]);
+	Control = openRaw(argv[2]);
+	Host_Init();
+	if(!Host_MapPrivate())
+	{
+		fprintf(stderr, "link_uart5: cannot map the NVIC, build without -fsanitize=address\n");
+		return 2;
+	}
+	SYSCTL_RIS_R = SYSCTL_RIS_PLLLRIS;   // PLL_Init waits for lock
+	ADC0_RIS_R = 0x08;                   // each conversion is done at once
+	GPIO_PORTF_DATA_R = 0x10;            // PF4 released, a master
+	SSI0_SR_R = SSI_SR_TNF;              // the LCD never stalls
+	Start = Last = cycles();
+	if(argc > 3) {Stop = (uint64_t)(atof(argv[3])*BUS_HZ);}
+	Host_StartInterrupts(tick);
+	firmware_main();
+	return 0;
+}
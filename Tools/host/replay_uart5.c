@@ -0,0 +1,363 @@
+// replay_uart5.c
+// Replays a UART5 capture taken with ESP8266_CAPTURE, the format
+// Tools/esp8266replay.py reads, into the firmware running on a PC.
+// Time is simulated: every 10 ms Blynk_to_TM4C runs as Timer2 would,
+// every 0.5 s SendInformation runs as Timer3 would, the R lines are
+// received at their recorded times through UART5_Handler and the
+// transmit tiers are drained onto a 9600 baud wire. The screen loop of
+// masterMain does not run. A day of traffic replays in seconds; a speed
+// of 1 replays it in real time.
+//
+// After each SendInformation, PB4-2 (heater, water, light) and the grow
+// light duty are checked: the heater must be on exactly when the reading
+// is at or below the VP20 limit, and the duty must be the VP21 schedule's
+// entry for the hour or, where that is -1, the last VP1 write. The k-th reading is the
+// k-th VP74 value in the capture's T lines, so the replay sees the
+// sensor data the capture saw; each virtual pin must send as many lines
+// as the capture shows, within 10%. Prints one CSV line per check that
+// fails and per actuator change, then a summary, and exits 1 on any
+// failure.
+//   cd GardenTelemetry
+//   gcc -std=gnu99 -Wall -fsanitize=address,undefined -I.. -I../Tools/host -o replay_uart5 ../Tools/host/replay_uart5.c ../Tools/host/host.c frame.c qformat.c clock.c ui.c fixed.c ST7735.c histogram.c dashboard.c timeseries.c events.c stats.c PWM.c Timer.c UART.c ADCSWTrigger.c PortF.c PLL.c SysTick.c
+//   ./replay_uart5 ../Tools/replay/session.txt
+//   ./replay_uart5 ../Tools/replay/session.txt 1     real time
+//   ./replay_uart5 -w ../Tools/replay/session.txt    prints the replay as a capture
+// The capture is CSV only; binary frames are not replayed.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "uart5host.h"
+#include "GardenTelemetry/esp8266.c"
+#define main firmware_main
+#include "GardenTelemetry/Blynk.c"
+#undef main
+
+#define TICK_MS      (1000 / EVENT_TICK_HZ)
+#define SEND_MS      (SEND_PERIOD / 80000)
+#define WIRE_TENTHS  96      // tenths of a byte per tick at 9600 baud, 10 bits a byte
+#define ACTUATORS    0x1C    // PB4-2
+
+typedef struct
+{
+	char direction;            // 'R' or 'T'
+	uint32_t ms;
+	uint8_t *data;             // a whole line, ending in '\n'
+	uint32_t length;
+} Record;
+
+Record static *Records;
+uint32_t static NumRecords = 0;
+
+// uplink lines per virtual pin, in the capture and in the replay
+#define PINS 256
+uint32_t static Want[PINS];
+uint32_t static Got[PINS];
+int32_t static *Readings;      // VP74 values of the capture, in order
+uint32_t static NumReadings = 0;
+
+int static Write = 0;          // -w, print the replay as a capture
+uint32_t static Failures = 0;
+uint32_t static Checks = 0;
+uint32_t static NowMs = 0;
+int32_t static Manual = 0;       // the last VP1 write
+
+uint32_t static unescape(const char *text, uint8_t *out)
+{
+	uint32_t n = 0;
+	while(*text)
+	{
+		if((text[0] == '\\') && text[1])
+		{
+			char c = text[1];
+			if((c == 'x') && text[2] && text[3])
+			{
+				char hex[3] = {text[2], text[3], 0};
+				out[n++] = (uint8_t)strtoul(hex, NULL, 16);
+				text += 4;
+				continue;
+			}
+			out[n++] = (c == 'n') ? '\n' : (c == 'r') ? '\r' : c;
+			text += 2;
+			continue;
+		}
+		out[n++] = (uint8_t)*text++;
+	}
+	return n;
+}
+
+void static escape(const uint8_t *data, uint32_t length)
+{
+	for(uint32_t i = 0; i < length; i++)
+	{
+		uint8_t c = data[i];
+		if(c == '\n') {fputs("\\n", stdout);}
+		else if(c == '\r') {fputs("\\r", stdout);}
+		else if(c == '\\') {fputs("\\\\", stdout);}
+		else if((c < ' ') || (c > '~')) {printf("\\x%02X", c);}
+		else {putchar(c);}
+	}
+}
+
+uint32_t static pinOf(const uint8_t *data, uint32_t length)
+{
+	uint32_t pin = 0, i;
+	for(i = 0; (i < length) && (data[i] >= '0') && (data[i] <= '9') && (pin < PINS); i++)
+	{
+		pin = 10*pin + (data[i] - '0');
+	}
+	return ((i == 0) || (pin >= PINS)) ? PINS - 1 : pin;
+}
+
+// records split across capture lines are joined, like esp8266replay.py does
+int static load(const char *path)
+{
+	static char line[4096];
+	static uint8_t text[4096];
+	Record partial[2] = {{0}};
+	uint32_t size = 0;
+	FILE *f = fopen(path, "r");
+	if(f == NULL)
+	{
+		perror(path);
+		return 0;
+	}
+	while(fgets(line, sizeof(line), f))
+	{
+		char direction; unsigned long ms; int start;
+		line[strcspn(line, "\r\n")] = 0;
+		if((sscanf(line, "%c %lu %n", &direction, &ms, &start) < 2) || ((direction != 'R') && (direction != 'T')) || (line[1] != ' '))
+		{
+			continue;          // other UART0 output
+		}
+		Record *r = &partial[direction == 'T'];
+		uint32_t n = unescape(&line[start], text);
+		if(r->data == NULL)
+		{
+			r->direction = direction;
+			r->ms = ms;
+		}
+		r->data = realloc(r->data, r->length + n + 1);
+		memcpy(&r->data[r->length], text, n);
+		r->length += n;
+		if((n > 0) && (text[n-1] == '\n'))
+		{
+			if(NumRecords == size)
+			{
+				size = size ? 2*size : 256;
+				Records = realloc(Records, size*sizeof(Record));
+			}
+			Records[NumRecords++] = *r;
+			r->data = NULL;
+			r->length = 0;
+		}
+	}
+	fclose(f);
+	for(uint32_t i = 0; i < NumRecords; i++)
+	{
+		Record *r = &Records[i];
+		if(r->direction != 'T') {continue;}
+		uint32_t pin = pinOf(r->data, r->length);
+		Want[pin]++;
+		if(pin == 74)
+		{
+			Readings = realloc(Readings, (NumReadings + 1)*sizeof(int32_t));
+			Readings[NumReadings++] = atoi((char *)&r->data[3]);
+		}
+	}
+	free(partial[0].data);
+	free(partial[1].data);
+	return 1;
+}
+
+void static fail(const char *what, int32_t got, int32_t want)
+{
+	printf("FAIL,%u,%s,%d,%d\n", (unsigned)NowMs, what, (int)got, (int)want);
+	Failures++;
+}
+
+uint32_t static duty(void)
+{
+	return (PWM0_0_CMPB_R + 1) & 0xFFFF;   // PWM0B_Duty writes duty-1
+}
+
+// the bytes the board would put on the wire in one tick, whole lines counted
+void static wire(uint32_t *tenths)
+{
+	static uint8_t line[TX5QUEUESIZE];
+	static uint32_t length = 0;
+	*tenths += WIRE_TENTHS;
+	while(*tenths >= 10)
+	{
+		if(Tx5Left == 0)
+		{
+			if(tx5NextMessage() == FIFOFAIL) {break;}
+			continue;
+		}
+		uint8_t c = Tx5Current[Tx5CurrentI++];
+		Tx5Left--;
+		Tx5Bytes[Tx5Tier]++;
+		*tenths -= 10;
+		line[length++] = c;
+		if((c == '\n') || (length == sizeof(line)))
+		{
+			Got[pinOf(line, length)]++;
+			if(Write)
+			{
+				printf("T %u ", (unsigned)NowMs);
+				escape(line, length);
+				printf("\n");
+			}
+			length = 0;
+		}
+	}
+	if(*tenths > 10*UART5_HOST_FIFO) {*tenths = 10*UART5_HOST_FIFO;}  // the line was idle
+}
+
+// what the firmware was asked to do by the message it just took
+void static checkMessage(void)
+{
+	uint32_t pin = pinOf((uint8_t *)serial_buf, strlen(serial_buf));
+	if(pin == 1) {Manual = atoi(&serial_buf[2]);}
+}
+
+void static checkSample(int32_t reading)
+{
+	Checks += 2;
+	int heater = (GPIO_PORTB_DATA_R >> HEATER_PIN) & 1;
+	if(heater != (reading <= readingLimit1)) {fail("heater", heater, reading <= readingLimit1);}
+	int32_t want = lightSchedule[getHourOfDay()];
+	if(want < 0) {want = Manual;}
+	if(duty() != (uint16_t)(400*want)) {fail("light_duty", duty(), 400*want);}
+}
+
+void static waitUntil(struct timespec *start, uint32_t simMs, double speed)
+{
+	if(speed <= 0) {return;}
+	double due = simMs / 1000.0 / speed;
+	for(;;)
+	{
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		double elapsed = (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+		if(elapsed >= due) {return;}
+		struct timespec nap = {0, (long)((due - elapsed) * 1e9)};
+		nanosleep(&nap, NULL);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int arg = 1;
+	double speed = 0;
+	if((argc > 1) && (strcmp(argv[1], "-w") == 0))
+	{
+		Write = 1;
+		arg++;
+	}
+	if((arg >= argc) || !load(argv[arg]))
+	{
+		fprintf(stderr, "usage: replay_uart5 [-w] capture [speed]\n");
+		return 2;
+	}
+	if(arg + 1 < argc) {speed = atof(argv[arg + 1]);}
+	if(NumRecords == 0)
+	{
+		fprintf(stderr, "no records in %s\n", argv[arg]);
+		return 2;
+	}
+
+	Host_Init();
+	SSI0_SR_R = SSI_SR_TNF;		//transmit FIFO never full, never busy
+	ST7735_InitR(INITR_REDTAB);
+	initActuators();
+	initSensors();
+	ADC0_RIS_R = 0x08;				//every conversion is done at once
+	TimeSeries_Init(SAMPLES_PER_MINUTE);
+	initSensorGraph();
+	Stats_Init(STATS_WINDOW);
+	Rx5Fifo_Init();
+	Tx5Fifo_Init();
+	PWM0B_Duty(400 * growLightOutput);
+	isMaster = 1;
+
+	uint32_t first = Records[0].ms, last = Records[NumRecords - 1].ms;
+	uint32_t next = 0, sent = 0, lines = 0, samples = 0, tenths = 0;
+	uint32_t lastPortB = GPIO_PORTB_DATA_R & ACTUATORS, lastDuty = duty();
+	struct timespec start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	if(!Write) {printf("actuator,ms,portb,duty\n");}
+	for(uint32_t ms = 0; ms <= last - first + 2000; ms += TICK_MS)
+	{
+		NowMs = first + ms;
+		waitUntil(&start, ms, speed);
+		if(Uart5HostLeft == 0)
+		{
+			while((next < NumRecords) && (Records[next].direction != 'R')) {next++;}
+			if((next < NumRecords) && (Records[next].ms <= NowMs))
+			{
+				Record *r = &Records[next++];
+				Uart5Host_Receive(r->data, r->length);
+				if(Write)
+				{
+					printf("R %u ", (unsigned)NowMs);
+					escape(r->data, r->length);
+					printf("\n");
+				}
+				sent += r->length;
+				lines++;
+			}
+		}
+		Uart5Host_Refill();
+		UART5_RIS_R = UART_RIS_RXRIS;
+		UART5_Handler();
+
+		uint32_t taken = ESP8266_MessageCount();
+		Blynk_to_TM4C();                    // Timer2
+		if(ESP8266_MessageCount() != taken) {checkMessage();}
+		if((ms % SEND_MS) == 0 && ms > 0)   // Timer3
+		{
+			int32_t reading = NumReadings ? Readings[(samples < NumReadings) ? samples : NumReadings - 1] : 2000;
+			ADC0_SSFIFO3_R = reading;
+			SendInformation();
+			checkSample(reading);
+			samples++;
+		}
+		wire(&tenths);
+
+		uint32_t portB = GPIO_PORTB_DATA_R & ACTUATORS;
+		if(!Write && ((portB != lastPortB) || (duty() != lastDuty)))
+		{
+			printf("actuator,%u,0x%02X,%u\n", (unsigned)NowMs, (unsigned)portB, (unsigned)duty());
+			lastPortB = portB;
+			lastDuty = duty();
+		}
+	}
+	if(Write) {return 0;}
+
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	printf("replayed_lines,%u\n", (unsigned)lines);
+	printf("replayed_bytes,%u\n", (unsigned)sent);
+	printf("simulated_s,%.1f\n", (last - first) / 1000.0);
+	printf("elapsed_s,%.2f\n", elapsed);
+	printf("actuator_checks,%u\n", (unsigned)Checks);
+	for(uint32_t pin = 0; pin < PINS; pin++)
+	{
+		if((Want[pin] == 0) && (Got[pin] == 0)) {continue;}
+		uint32_t slack = (Want[pin] / 10 > 2) ? Want[pin] / 10 : 2;
+		int ok = (Got[pin] + slack >= Want[pin]) && (Got[pin] <= Want[pin] + slack);
+		printf("uplink_pin_%u,%u,%u,%s\n", (unsigned)pin, (unsigned)Got[pin], (unsigned)Want[pin], ok ? "ok" : "MISMATCH");
+		if(!ok) {Failures++;}
+	}
+	if(Failures)
+	{
+		printf("%u failures\n", (unsigned)Failures);
+		return 1;
+	}
+	printf("replay ok\n");
+	return 0;
+}
@@ -0,0 +1,106 @@
+// test_clock.c
+// Host test for the time of day in GardenTelemetry/clock.c: the bulk time
+// message (setTimeOfDay) arrives in each screen mode, Timer0 ticks on,
+// and the hour the light schedule reads and the time the clock screen
+// shows afterwards must both follow it, while the alarm stays as it was.
+// Prints each failure and exits 1 if there was any.
+//   cd GardenTelemetry
+//   gcc -std=gnu99 -Wall -fsanitize=address,undefined -I.. -I../Tools/host -o test_clock ../Tools/host/test_clock.c ../Tools/host/host.c clock.c ui.c fixed.c ST7735.c histogram.c qformat.c dashboard.c timeseries.c events.c
+//   ./test_clock
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "host.h"
+#include "inc/tm4c123gh6pm.h"
+#include "GardenTelemetry/clock.h"
+#include "GardenTelemetry/Timer.h"
+
+extern int hours, minutes, seconds, alarmHours, alarmMinutes;
+extern char *merridian;
+
+// what the firmware gets from modules that are not built here
+void UART_OutCharPolled(char data) {putchar(data);}
+void PWM0A_Init(uint16_t period, uint16_t duty) {(void)period; (void)duty;}
+uint32_t ESP8266_MessageCount(void) {return 0;}
+uint32_t ESP8266_OutputQueueSize(void) {return 0;}
+void Timer0_Init(void(*task)(void), uint32_t period) {(void)task; (void)period;}
+
+int Failures = 0;
+
+void static expect(const char *mode, const char *what, int got, int want)
+{
+	if(got != want)
+	{
+		printf("%s: %s %d, want %d\n", mode, what, got, want);
+		Failures++;
+	}
+}
+
+void static enter(int mode)
+{
+	setMode(mode);
+	switch(mode)
+	{
+		case CLOCK_MODE: clockMode(); break;
+		case SET_ALARM_MODE: setAlarmMode(); break;
+		case GRAPH_SENSORS_MODE: graphSensorsMode(); break;
+		case DASHBOARD_MODE: dashboardMode(); break;
+		default: stripChartMode(); break;
+	}
+}
+
+// hour:59:58 set from mode, two Timer0 seconds there, then back to the clock
+void static setFrom(int mode, const char *name, int hour)
+{
+	int next = (hour + 1) % 24;
+	enter(CLOCK_MODE);
+	enter(mode);
+	int alarm = alarmHours*60 + alarmMinutes;
+	int shown = hours*3600 + minutes*60 + seconds;
+	setTimeOfDay(hour, 59, 58);
+	expect(name, "hour of day", getHourOfDay(), hour);
+	updateTime();
+	updateTime();
+	expect(name, "hour of day after 2 s", getHourOfDay(), next);
+	if(mode == SET_ALARM_MODE)
+	{
+		expect(name, "alarm digits", hours*3600 + minutes*60 + seconds, shown);
+	}
+	enter(CLOCK_MODE);
+	expect(name, "alarm", alarmHours*60 + alarmMinutes, alarm);
+	expect(name, "clock hours", hours, (next % 12 == 0) ? 12 : next % 12);
+	expect(name, "clock minutes", minutes, 0);
+	expect(name, "clock seconds", seconds, 0);
+	expect(name, "clock am/pm", strcmp(merridian, (next < 12) ? "am" : "pm"), 0);
+}
+
+int main(void)
+{
+	Host_Init();
+	SSI0_SR_R = SSI_SR_TNF;		//transmit FIFO never full, never busy
+	initSensorGraph();
+	setFrom(CLOCK_MODE, "clock", 13);
+	setFrom(SET_ALARM_MODE, "alarm", 6);
+	setFrom(GRAPH_SENSORS_MODE, "graph", 11);
+	setFrom(DASHBOARD_MODE, "dashboard", 20);
+	setFrom(STRIP_CHART_MODE, "strip chart", 23);
+	// the clock screen's own setters still set the time of day
+	setTimeOfDay(9, 0, 0);
+	setHour(11);
+	toggleMerridian();
+	expect("clock", "hour after setHour and toggle", getHourOfDay(), 23);
+	updateTime();
+	expect("clock", "a second later", getHourOfDay(), 23);
+	setTimeOfDay(23, 59, 59);
+	updateTime();
+	expect("clock", "after midnight", getHourOfDay(), 0);
+	expect("clock", "12 am", hours, 12);
+	if(Failures)
+	{
+		printf("%d failures\n", Failures);
+		return 1;
+	}
+	printf("clock ok\n");
+	return 0;
+}
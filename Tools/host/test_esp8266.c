@@ -0,0 +1,89 @@
+// test_esp8266.c
+// Host test for the binary handshake of GardenTelemetry/esp8266.c. The
+// bridge's reply to the credentials goes through UART5_Handler,
+// Rx5Fifo_Put and ESP8266_GetMessage, as ESP8266_SetupWiFi drains it,
+// and must be accepted only when it echoes the offer. Also checks that
+// ESP8266_OutChar, OutString and OutUDec report a line the telemetry tier
+// refuses. Prints each failure and exits 1 if there was any.
+//   cd GardenTelemetry
+//   gcc -std=gnu99 -Wall -fsanitize=address,undefined -DESP8266_BINARY -I.. -I../Tools/host -o test_esp8266 ../Tools/host/test_esp8266.c ../Tools/host/host.c frame.c qformat.c events.c UART.c ST7735.c
+//   ./test_esp8266
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "uart5host.h"
+#include "GardenTelemetry/esp8266.c"
+
+int Failures = 0;
+
+// accepted is what ESP8266_SetupWiFi would decide from the reply
+void static expectReply(const char *reply, int want)
+{
+	int accepted = 0, messages = 0;
+	Rx5Fifo_Init();
+	BinaryMode = 0;
+	Uart5Host_Receive((const uint8_t *)reply, strlen(reply));
+	while(Uart5Host_Refill())
+	{
+		UART5_RIS_R = UART_RIS_RXRIS;
+		UART5_Handler();
+	}
+	while(ESP8266_GetMessage(RxMessage))
+	{
+		messages++;
+		if(binaryAccepted(RxMessage)) {accepted = 1;}
+	}
+	if(messages == 0 || accepted != want)
+	{
+		printf("reply \"%.*s\": %d messages, accepted %d, want %d\n",
+		       (int)strcspn(reply, "\n"), reply, messages, accepted, want);
+		Failures++;
+	}
+}
+
+void static expectCount(const char *what, uint32_t got, uint32_t want)
+{
+	if(got != want)
+	{
+		printf("%s: %u, want %u\n", what, (unsigned)got, (unsigned)want);
+		Failures++;
+	}
+}
+
+// the transmitter never drains here, so a REJECT tier fills and stays full
+void static expectOutput(void)
+{
+	Tx5Fifo_Init();
+	ESP8266_SetTxPolicy(ESP8266_TELEMETRY, ESP8266_REJECT);
+	expectCount("OutChar mid line", ESP8266_OutChar('7'), 1);
+	expectCount("OutChar at the end", ESP8266_OutChar('\n'), 2);
+	expectCount("OutString", ESP8266_OutString("12,34\n"), 6);
+	expectCount("OutUDec", ESP8266_OutUDec(4294967295u), 10);
+	expectCount("OutChar after OutUDec", ESP8266_OutChar('\n'), 11);
+	while(ESP8266_OutChar('\n')) {}	//one byte lines until not even one fits
+	expectCount("OutString, line refused", ESP8266_OutString("ab\ncd"), 2);
+	expectCount("OutChar, line refused", ESP8266_OutChar('\n'), 0);
+	ESP8266_SetTxPolicy(ESP8266_TELEMETRY, ESP8266_DROP_OLDEST);
+	Tx5Fifo_Init();
+}
+
+int main(void)
+{
+	Host_Init();
+	expectReply(BINARY_OFFER ",\n", 1);
+	expectReply("connected\n" BINARY_OFFER ",\n", 1);
+	expectReply(BINARY_OFFER "\n", 1);         // stored with the ',' added
+	expectReply("connected\n", 0);
+	expectReply("74,1200,\n", 0);
+	expectReply("cobs2,\n", 0);
+	expectReply("cobs10,\n", 0);
+	expectOutput();
+	if(Failures)
+	{
+		printf("%d failures\n", Failures);
+		return 1;
+	}
+	printf("esp8266 handshake and output ok\n");
+	return 0;
+}
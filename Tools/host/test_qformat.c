@@ -0,0 +1,148 @@
+// test_qformat.c
+// Host test for GardenTelemetry/qformat.c, checks the Q16.16 and Q8.8
+// operations and the Fmt_ formatters against known values, including
+// rounding of halves and saturation at both ends. Prints each failure
+// and exits 1 if there was any. qformat.c touches no registers, so this
+// test needs nothing from host.c.
+//   cd GardenTelemetry
+//   gcc -std=c99 -Wall -fsanitize=address,undefined -I.. -I../Tools/host -o test_qformat ../Tools/host/test_qformat.c qformat.c
+//   ./test_qformat
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "GardenTelemetry/qformat.h"
+
+int Failures = 0;
+
+#define EXPECT(expr, want) expect((int64_t)(expr), (int64_t)(want), #expr, __LINE__)
+#define EXPECT_TEXT(call, want) expectText(call, want, #call, __LINE__)
+
+char Buf[32];
+
+void static expect(int64_t got, int64_t want, const char *expr, int line)
+{
+	if(got != want)
+	{
+		printf("line %d: %s gave %lld, want %lld\n", line, expr, (long long)got, (long long)want);
+		Failures++;
+	}
+}
+
+// call has written Buf and returned its length
+void static expectText(uint32_t length, const char *want, const char *call, int line)
+{
+	if(strcmp(Buf, want) != 0 || length != strlen(want))
+	{
+		printf("line %d: %s gave \"%s\" (%u), want \"%s\"\n", line, call, Buf, (unsigned)length, want);
+		Failures++;
+	}
+}
+
+void static testQ16(void)
+{
+	EXPECT(Q16_FromInt(3), 0x30000);
+	EXPECT(Q16_FromInt(-2), -0x20000);
+	EXPECT(Q16_ToInt(0x18000), 2);              // 1.5 rounds away from zero
+	EXPECT(Q16_ToInt(-0x18000), -2);
+	EXPECT(Q16_ToInt(0x17FFF), 1);
+	EXPECT(Q16_ToInt(Q16_MAX), 32768);
+
+	EXPECT(Q16_Mul(Q16_FromInt(3), Q16_FromInt(4)), Q16_FromInt(12));
+	EXPECT(Q16_Mul(Q16_ONE / 2, Q16_ONE / 2), Q16_ONE / 4);
+	EXPECT(Q16_Mul(-Q16_FromInt(3), Q16_ONE / 2), -0x18000);
+	EXPECT(Q16_Mul(1, 0x8000), 1);              // 2^-16 * 0.5 rounds up to 2^-16
+	EXPECT(Q16_Mul(-1, 0x8000), -1);
+	EXPECT(Q16_Mul(Q16_FromInt(300), Q16_FromInt(300)), Q16_MAX);
+	EXPECT(Q16_Mul(Q16_FromInt(-300), Q16_FromInt(300)), Q16_MIN);
+	EXPECT(Q16_Mul(Q16_MIN, Q16_MIN), Q16_MAX);
+
+	EXPECT(Q16_Div(Q16_FromInt(1), Q16_FromInt(4)), Q16_ONE / 4);
+	EXPECT(Q16_Div(Q16_FromInt(1), Q16_FromInt(3)), 0x5555);
+	EXPECT(Q16_Div(Q16_FromInt(2), Q16_FromInt(3)), 0xAAAB);
+	EXPECT(Q16_Div(Q16_FromInt(-2), Q16_FromInt(3)), -0xAAAB);
+	EXPECT(Q16_Div(Q16_FromInt(7), 0), Q16_MAX);
+	EXPECT(Q16_Div(Q16_FromInt(-7), 0), Q16_MIN);
+	EXPECT(Q16_Div(Q16_FromInt(30000), 1), Q16_MAX);
+	EXPECT(Q16_Div(Q16_MIN, -Q16_ONE), Q16_MAX);
+
+	EXPECT(Q16_Recip(Q16_FromInt(2)), Q16_ONE / 2);
+	EXPECT(Q16_Recip(-Q16_FromInt(8)), -Q16_ONE / 8);
+	EXPECT(Q16_Recip(1), Q16_MAX);
+	EXPECT(Q16_Recip(0), Q16_MAX);
+}
+
+void static testQ8(void)
+{
+	EXPECT(Q8_FromInt(5), 0x500);
+	EXPECT(Q16_FromQ8(Q8_FromInt(-3)), -0x30000);
+	EXPECT(Q8_FromQ16(0x28000), 0x280);
+
+	EXPECT(Q8_Mul(Q8_FromInt(3), Q8_FromInt(-4)), Q8_FromInt(-12));
+	EXPECT(Q8_Mul(0x80, 0x80), 0x40);          // 0.5 * 0.5
+	EXPECT(Q8_Mul(1, 0x80), 1);
+	EXPECT(Q8_Mul(Q8_FromInt(100), Q8_FromInt(100)), Q8_MAX);
+	EXPECT(Q8_Mul(Q8_FromInt(-100), Q8_FromInt(100)), Q8_MIN);
+
+	EXPECT(Q8_Div(Q8_FromInt(1), Q8_FromInt(3)), 0x55);
+	EXPECT(Q8_Div(Q8_FromInt(2), Q8_FromInt(3)), 0xAB);
+	EXPECT(Q8_Div(Q8_FromInt(100), 1), Q8_MAX);
+	EXPECT(Q8_Div(Q8_FromInt(1), 0), Q8_MAX);
+	EXPECT(Q8_Div(Q8_FromInt(-1), 0), Q8_MIN);
+	EXPECT(Q8_Recip(Q8_FromInt(4)), 0x40);
+}
+
+void static testScaled(void)
+{
+	EXPECT(Q16_FromScaled(1500, 1000), 0x18000);
+	EXPECT(Q16_FromScaled(-250, 100), -0x28000);
+	EXPECT(Q16_FromScaled(1, 3), 0x5555);
+	EXPECT(Q16_FromScaled(0x7FFFFFFF, 1), Q16_MAX);
+	EXPECT(Q16_FromScaled(-0x7FFFFFFF, 1), Q16_MIN);
+
+	EXPECT(Q16_ToScaled(0x18000, 1000), 1500);
+	EXPECT(Q16_ToScaled(Q16_ONE / 3, 1000), 333);
+	EXPECT(Q16_ToScaled(-Q16_ONE * 2 / 3, 1000), -667);
+	EXPECT(Q16_ToScaled(Q16_MAX, 1000000), 0x7FFFFFFF);
+	EXPECT(Q16_ToScaled(Q16_MIN, 1000000), -0x7FFFFFFF - 1);
+}
+
+void static testFmt(void)
+{
+	EXPECT_TEXT(Fmt_UDec(Buf, 0), "0");
+	EXPECT_TEXT(Fmt_UDec(Buf, 42), "42");
+	EXPECT_TEXT(Fmt_UDec(Buf, 4294967295u), "4294967295");
+	EXPECT_TEXT(Fmt_UDecPad(Buf, 7, 3, '0'), "007");
+	EXPECT_TEXT(Fmt_UDecPad(Buf, 12, 4, ' '), "  12");
+	EXPECT_TEXT(Fmt_UDecPad(Buf, 12345, 2, '0'), "12345");
+
+	EXPECT_TEXT(Fmt_Fixed(Buf, -102, 2), "-1.02");
+	EXPECT_TEXT(Fmt_Fixed(Buf, 5, 3), "0.005");
+	EXPECT_TEXT(Fmt_Fixed(Buf, -5, 3), "-0.005");
+	EXPECT_TEXT(Fmt_Fixed(Buf, 1234, 0), "1234");
+	EXPECT_TEXT(Fmt_Fixed(Buf, -0x7FFFFFFF - 1, 0), "-2147483648");
+	EXPECT_TEXT(Fmt_Fixed(Buf, -0x7FFFFFFF - 1, 9), "-2.147483648");
+	EXPECT_TEXT(Fmt_Fixed(Buf, 1, 12), "0.000000001");   // decimals capped at 9
+
+	EXPECT_TEXT(Fmt_Q16(Buf, 0x18000, 1), "1.5");
+	EXPECT_TEXT(Fmt_Q16(Buf, Q16_ONE / 3, 3), "0.333");
+	EXPECT_TEXT(Fmt_Q16(Buf, -Q16_ONE * 2 / 3, 2), "-0.67");
+	EXPECT_TEXT(Fmt_Q16(Buf, Q16_FromInt(-12), 0), "-12");
+	EXPECT_TEXT(Fmt_Q16(Buf, Q16_MAX, 4), "32768.0000");  // 32767.99998 rounds up
+	EXPECT_TEXT(Fmt_Q16(Buf, Q16_ONE, 6), "1.0000");     // decimals capped at 4
+}
+
+int main(void)
+{
+	testQ16();
+	testQ8();
+	testScaled();
+	testFmt();
+	if(Failures)
+	{
+		printf("%d failures\n", Failures);
+		return 1;
+	}
+	printf("qformat ok\n");
+	return 0;
+}
@@ -0,0 +1,83 @@
+// uart5host.h
+// A UART5 for esp8266.c on a PC. Include it just before
+// GardenTelemetry/esp8266.c in the one file that builds the driver.
+// The receiver plays back a byte string, at most UART5_HOST_FIFO
+// characters per Uart5Host_Refill as the hardware FIFO would hold them.
+// The transmitter always reports full, so queued output stays queued.
+// Byte 0xFE in the string is an escape. The next byte holds error flags,
+// bit 0 overrun, bit 1 framing, bit 2 parity and bit 3 break, and the
+// byte after that is the character received with them. 0xFE 0x00 0xFE
+// is a plain 0xFE.
+
+#ifndef UART5HOST_H
+#define UART5HOST_H
+
+#include <stdint.h>
+#include "host.h"
+#include "inc/tm4c123gh6pm.h"
+
+#define UART5_HOST_FIFO 16
+#define UART5_HOST_ESCAPE 0xFE
+
+const uint8_t static *Uart5HostIn;
+uint32_t static Uart5HostLeft = 0;       // bytes of the string not yet received
+uint32_t static Uart5HostFifo = 0;       // characters the hardware FIFO holds now
+uint32_t volatile static Uart5HostData;
+
+//------------Uart5Host_Receive------------
+// Inputs:  data    bytes the ESP8266 sends, with escapes as above
+//          length  number of bytes
+// Outputs: none
+void static Uart5Host_Receive(const uint8_t *data, uint32_t length)
+{
+	Uart5HostIn = data;
+	Uart5HostLeft = length;
+	Uart5HostFifo = 0;
+}
+
+//------------Uart5Host_Refill------------
+// Moves up to a FIFO full of the string into the receiver
+// Inputs:  none
+// Outputs: 1 if any of the string is still to be received
+int static Uart5Host_Refill(void)
+{
+	Uart5HostFifo = UART5_HOST_FIFO;
+	return Uart5HostLeft > 0;
+}
+
+uint32_t static uart5HostFlags(void)
+{
+	uint32_t flags = UART_FR_TXFF;
+	if((Uart5HostLeft == 0) || (Uart5HostFifo == 0)) {flags |= UART_FR_RXFE;}
+	return flags;
+}
+
+// each read of the data register takes the next character
+uint32_t volatile static *uart5HostData(void)
+{
+	uint32_t flags = 0;
+	Uart5HostData = 0;
+	if((Uart5HostLeft == 0) || (Uart5HostFifo == 0)) {return &Uart5HostData;}
+	Uart5HostFifo--;
+	if((*Uart5HostIn == UART5_HOST_ESCAPE) && (Uart5HostLeft >= 3))
+	{
+		flags = Uart5HostIn[1];
+		Uart5HostIn += 2;
+		Uart5HostLeft -= 2;
+	}
+	Uart5HostData = *Uart5HostIn;
+	if(flags & 0x01) {Uart5HostData |= UART_DR_OE;}
+	if(flags & 0x02) {Uart5HostData |= UART_DR_FE;}
+	if(flags & 0x04) {Uart5HostData |= UART_DR_PE;}
+	if(flags & 0x08) {Uart5HostData |= UART_DR_BE;}
+	Uart5HostIn++;
+	Uart5HostLeft--;
+	return &Uart5HostData;
+}
+
+#undef UART5_FR_R
+#undef UART5_DR_R
+#define UART5_FR_R (uart5HostFlags())
+#define UART5_DR_R (*uart5HostData())
+
+#endif
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+# st7735emu.py
+# Replays an SSI0 trace through a model of the ST7735 controller and
+# writes one PNG per frame plus a line of statistics per frame.
+#   python3 Tools/st7735emu.py trace.txt out/frame
+# writes out/frame0001.png, out/frame0002.png, ... and prints CSV to stdout.
+#
+# The trace is what the firmware prints on UART0 with ST7735_TRACE
+# defined in ST7735.h: one line per command, "C" and the command byte in
+# hex followed by its data bytes, and a line holding "F" at the end of
+# each frame. Lines that do not parse, such as other debug output on the
+# same port, are skipped.
+#
+# Modeled: CASET, RASET, RAMWR (16-bit color only), MADCTL, VSCRDEF,
+# VSCSAD and NORON. Pixels are kept where the firmware addressed them,
+# so the image shows the screen as the driver sees it in its current
+# rotation; the MADCTL mirror bits are only reported, not applied.
+# The scroll area is applied when the image is saved, as on the panel.
+# Tools/st7735golden.py uses the same model to check the traces in
+# Tools/golden against reference images.
+import argparse
+import struct
+import sys
+import zlib
+
+CASET, RASET, RAMWR = 0x2A, 0x2B, 0x2C
+MADCTL, VSCRDEF, VSCSAD, NORON = 0x36, 0x33, 0x37, 0x13
+MADCTL_BGR = 0x08
+GRAM_WIDTH, GRAM_HEIGHT = 132, 162
+
+
+class Controller:
+    def __init__(self):
+        self.gram = [[0] * GRAM_WIDTH for _ in range(GRAM_HEIGHT)]
+        self.cols = (0, GRAM_WIDTH - 1)
+        self.rows = (0, GRAM_HEIGHT - 1)
+        self.x, self.y = 0, 0
+        self.madctl = 0
+        self.scroll = None          # (top fixed, scroll rows) once VSCRDEF is sent
+        self.start = 0              # VSCSAD
+        self.scrolling = False
+        self.reset_stats()
+
+    def reset_stats(self):
+        self.stats = {"bytes": 0, "commands": 0, "windows": 0, "pixels": 0}
+
+    def command(self, cmd, data):
+        s = self.stats
+        s["bytes"] += 1 + len(data)
+        s["commands"] += 1
+        if cmd == CASET and len(data) >= 4:
+            self.cols = (data[0] << 8 | data[1], data[2] << 8 | data[3])
+        elif cmd == RASET and len(data) >= 4:
+            self.rows = (data[0] << 8 | data[1], data[2] << 8 | data[3])
+        elif cmd == RAMWR:
+            s["windows"] += 1
+            self.x, self.y = self.cols[0], self.rows[0]
+            for i in range(0, len(data) - 1, 2):
+                self.pixel(data[i] << 8 | data[i + 1])
+        elif cmd == MADCTL and data:
+            self.madctl = data[0]
+        elif cmd == VSCRDEF and len(data) >= 4:
+            self.scroll = (data[0] << 8 | data[1], data[2] << 8 | data[3])
+        elif cmd == VSCSAD and len(data) >= 2:
+            self.start = data[0] << 8 | data[1]
+            self.scrolling = True
+        elif cmd == NORON:
+            self.scrolling = False
+
+    def pixel(self, color):
+        if self.x < GRAM_WIDTH and self.y < GRAM_HEIGHT:
+            self.gram[self.y][self.x] = color
+        self.stats["pixels"] += 1
+        self.x += 1
+        if self.x > self.cols[1]:
+            self.x = self.cols[0]
+            self.y += 1
+            if self.y > self.rows[1]:
+                self.y = self.rows[0]
+
+    def source_row(self, row):
+        if not self.scrolling or self.scroll is None:
+            return row
+        top, count = self.scroll
+        if count == 0 or row < top or row >= top + count:
+            return row
+        return top + (row - top + self.start - top) % count
+
+    def rgb(self, color):
+        first, green, last = color >> 11, (color >> 5) & 0x3F, color & 0x1F
+        if self.madctl & MADCTL_BGR:
+            first, last = last, first
+        return (first * 255 // 31, green * 255 // 63, last * 255 // 31)
+
+    def image(self, col_start, row_start, width, height):
+        rows = []
+        for y in range(height):
+            line = self.gram[self.source_row(y + row_start)]
+            rows.append([self.rgb(line[x + col_start]) for x in range(width)])
+        return rows
+
+
+def write_png(path, rows):
+    height, width = len(rows), len(rows[0])
+    raw = b"".join(b"\x00" + bytes(c for p in row for c in p) for row in rows)
+
+    def chunk(kind, body):
+        return struct.pack(">I", len(body)) + kind + body + struct.pack(">I", zlib.crc32(kind + body))
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 2, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(raw, 9)))
+        f.write(chunk(b"IEND", b""))
+
+
+def parse(line):
+    """Returns (command, data bytes), "F" for a frame mark, or None."""
+    words = line.split()
+    if words == ["F"]:
+        return "F"
+    if not words or len(words[0]) != 3 or words[0][0] != "C":
+        return None
+    try:
+        values = [int(w, 16) for w in [words[0][1:]] + words[1:]]
+    except ValueError:
+        return None
+    if any(v > 0xFF for v in values):
+        return None
+    return values[0], values[1:]
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Render an ST7735 SSI0 trace to PNG frames")
+    ap.add_argument("trace", help="UART0 capture, - for stdin")
+    ap.add_argument("prefix", help="output images are <prefix>0001.png, ...")
+    ap.add_argument("--col-start", type=int, default=0, help="ColStart of the panel, 2 for green tab")
+    ap.add_argument("--row-start", type=int, default=0, help="RowStart of the panel, 1 for green tab")
+    ap.add_argument("--skip-empty", action="store_true", help="no image for frames that sent nothing")
+    args = ap.parse_args()
+
+    lcd = Controller()
+    source = sys.stdin if args.trace == "-" else open(args.trace)
+    frame = 0
+    print("frame,bytes,commands,windows,pixels,madctl")
+
+    def finish():
+        nonlocal frame
+        if args.skip_empty and lcd.stats["bytes"] == 0:
+            return
+        frame += 1
+        write_png("%s%04d.png" % (args.prefix, frame),
+                  lcd.image(args.col_start, args.row_start, 128, 160))
+        s = lcd.stats
+        print("%d,%d,%d,%d,%d,0x%02X" % (frame, s["bytes"], s["commands"], s["windows"], s["pixels"], lcd.madctl))
+        lcd.reset_stats()
+
+    for line in source:
+        item = parse(line)
+        if item == "F":
+            finish()
+        elif item is not None:
+            lcd.command(*item)
+    if lcd.stats["bytes"]:
+        finish()
+
+
+if __name__ == "__main__":
+    main()
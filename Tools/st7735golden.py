@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+# st7735golden.py
+# Golden image test for the LCD drawing code. Every trace in Tools/golden
+# is replayed through the controller model of st7735emu.py and each frame
+# is compared pixel by pixel with the reference image next to it.
+#   python3 Tools/st7735golden.py            prints each frame that differs, exits 1 if any
+#   python3 Tools/st7735golden.py --update   rewrites the reference images
+#
+# The traces are <name>.trace.gz, made on a PC by Tools/host/lcdtrace.c
+# (build line in its header), and the references are <name>0001.png,
+# <name>0002.png, ... one per frame mark. After a change to the drawing
+# code that is meant to change the screen, rerun lcdtrace, look at the
+# new frames and then --update.
+import argparse
+import glob
+import gzip
+import os
+import struct
+import sys
+import zlib
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import st7735emu
+
+GOLDEN = os.path.join(os.path.dirname(os.path.abspath(__file__)), "golden")
+WIDTH, HEIGHT = 128, 160
+
+
+def frames(path):
+    """Images of every frame in a trace, as st7735emu.py renders them."""
+    lcd = st7735emu.Controller()
+    images = []
+    with gzip.open(path, "rt", encoding="latin-1") as f:
+        for line in f:
+            item = st7735emu.parse(line)
+            if item == "F":
+                images.append(lcd.image(0, 0, WIDTH, HEIGHT))
+            elif item is not None:
+                lcd.command(*item)
+    return images
+
+
+def read_png(path):
+    """Rows of (r, g, b) from a PNG written by st7735emu.write_png."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("%s is not a PNG" % path)
+    i, idat, width, height = 8, b"", 0, 0
+    while i < len(data):
+        length, kind = struct.unpack(">I4s", data[i:i + 8])
+        body = data[i + 8:i + 8 + length]
+        if kind == b"IHDR":
+            width, height, depth, color = struct.unpack(">IIBB", body[:10])
+            if depth != 8 or color != 2:
+                raise ValueError("%s is not 8-bit RGB" % path)
+        elif kind == b"IDAT":
+            idat += body
+        i += 12 + length
+    raw = zlib.decompress(idat)
+    stride = 1 + 3 * width
+    rows = []
+    for y in range(height):
+        line = raw[y * stride:(y + 1) * stride]
+        if line[0] != 0:
+            raise ValueError("%s uses PNG filters, write it with st7735emu.py" % path)
+        rows.append([tuple(line[1 + 3 * x:4 + 3 * x]) for x in range(width)])
+    return rows
+
+
+def compare(got, want):
+    """(pixels that differ, first (x, y) that differs or None)."""
+    count, first = 0, None
+    for y in range(HEIGHT):
+        for x in range(WIDTH):
+            if got[y][x] != want[y][x]:
+                count += 1
+                first = first or (x, y)
+    return count, first
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Compare ST7735 traces with reference images")
+    ap.add_argument("--update", action="store_true", help="rewrite the reference images")
+    args = ap.parse_args()
+
+    traces = sorted(glob.glob(os.path.join(GOLDEN, "*.trace.gz")))
+    if not traces:
+        sys.exit("no traces in %s" % GOLDEN)
+    failed = 0
+    for trace in traces:
+        name = os.path.basename(trace)[:-len(".trace.gz")]
+        images = frames(trace)
+        for n, image in enumerate(images, 1):
+            reference = os.path.join(GOLDEN, "%s%04d.png" % (name, n))
+            if args.update:
+                st7735emu.write_png(reference, image)
+                continue
+            if not os.path.exists(reference):
+                print("%s frame %d: no reference %s" % (name, n, os.path.basename(reference)))
+                failed += 1
+                continue
+            count, first = compare(image, read_png(reference))
+            if count:
+                print("%s frame %d: %d pixels differ, first at x=%d y=%d" % (name, n, count, first[0], first[1]))
+                failed += 1
+        extra = os.path.join(GOLDEN, "%s%04d.png" % (name, len(images) + 1))
+        if not args.update and os.path.exists(extra):
+            print("%s: trace has %d frames but there are more references" % (name, len(images)))
+            failed += 1
+        print("%s: %d frames" % (name, len(images)))
+    if failed:
+        sys.exit("%d frames differ" % failed)
+
+
+if __name__ == "__main__":
+    main()